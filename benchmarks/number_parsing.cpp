@@ -0,0 +1,209 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+
+// Standalone micro-benchmark of reading the numbers of a number heavy glTF file the way vsg::JSONParser passes them to read_number(..),
+// as a std::istream over a memory buffer positioned at the number, with the parser advancing by the stream's tellg() afterwards.
+// Compares operator>>, collecting the characters into a std::string, collecting them into a stack buffer as gltf::parse_value(..) does,
+// and parsing directly from the parser's buffer as gltf::read_value(..) does. parse_number(..) mirrors gltf::parse_number(..).
+
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <streambuf>
+#include <string>
+#include <type_traits>
+
+namespace
+{
+    // streambuf over a memory range, equivalent to vsg::mem_buffer
+    class mem_buffer : public std::streambuf
+    {
+    public:
+        void set(const char* ptr, size_t size)
+        {
+            char* p = const_cast<char*>(ptr);
+            setg(p, p, p + size);
+        }
+
+    protected:
+        pos_type seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode) override
+        {
+            if (dir == std::ios_base::beg) setg(eback(), eback() + off, egptr());
+            else if (dir == std::ios_base::cur) gbump(static_cast<int>(off));
+            else setg(eback(), egptr() + off, egptr());
+            return pos_type(gptr() - eback());
+        }
+
+        pos_type seekpos(pos_type pos, std::ios_base::openmode mode) override
+        {
+            return seekoff(off_type(pos), std::ios_base::beg, mode);
+        }
+    };
+
+    constexpr size_t max_number_length = 128;
+
+    inline bool numberChar(int c)
+    {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+    }
+
+    template<typename T>
+    const char* parse_number(const char* first, const char* last, T& value, bool& valid)
+    {
+        const char* end = first;
+        for(; end != last && numberChar(*end); ++end) {}
+
+        T parsed{};
+        auto result = std::from_chars(first, end, parsed);
+        if (result.ec == std::errc() && result.ptr == end)
+        {
+            value = parsed;
+            valid = true;
+            return end;
+        }
+
+        if constexpr (std::is_integral_v<T>)
+        {
+            double d = 0.0;
+            auto dresult = std::from_chars(first, end, d);
+            if (dresult.ec == std::errc() && dresult.ptr == end && std::trunc(d) == d &&
+                d >= static_cast<double>(std::numeric_limits<T>::min()) && d <= static_cast<double>(std::numeric_limits<T>::max()))
+            {
+                value = static_cast<T>(d);
+                valid = true;
+                return end;
+            }
+        }
+
+        valid = false;
+        return end;
+    }
+
+    bool read_operator(std::istream& input, const std::string&, size_t, double& value)
+    {
+        return static_cast<bool>(input >> value);
+    }
+
+    // the characters collected into a std::string, allocating for numbers longer than the small string buffer
+    bool read_string(std::istream& input, const std::string&, size_t, double& value)
+    {
+        std::string str;
+        auto buffer = input.rdbuf();
+        for(auto c = buffer->sgetc(); c != std::char_traits<char>::eof() && numberChar(c); c = buffer->snextc()) str.push_back(static_cast<char>(c));
+
+        bool valid = false;
+        parse_number(str.data(), str.data() + str.size(), value, valid);
+        return valid;
+    }
+
+    // the characters collected into a stack buffer, as gltf::parse_value(..)
+    bool read_stack(std::istream& input, const std::string&, size_t, double& value)
+    {
+        char str[max_number_length];
+        size_t length = 0;
+        bool overflow = false;
+        auto buffer = input.rdbuf();
+        for(auto c = buffer->sgetc(); c != std::char_traits<char>::eof() && numberChar(c); c = buffer->snextc())
+        {
+            if (length < max_number_length) str[length++] = static_cast<char>(c);
+            else overflow = true;
+        }
+
+        bool valid = false;
+        if (!overflow) parse_number(str, str + length, value, valid);
+        return valid;
+    }
+
+    // parsed directly from the parser's buffer, as gltf::read_value(..)
+    bool read_direct(std::istream& input, const std::string& parserBuffer, size_t parserPos, double& value)
+    {
+        bool valid = false;
+        auto streambuf = input.rdbuf();
+        auto offset = streambuf->pubseekoff(0, std::ios::cur, std::ios::in);
+        size_t position = parserPos + static_cast<size_t>(offset);
+        if (offset != std::streampos(-1) && position < parserBuffer.size() && streambuf->sgetc() == parserBuffer[position])
+        {
+            const char* first = parserBuffer.data() + position;
+            const char* end = parse_number(first, parserBuffer.data() + parserBuffer.size(), value, valid);
+            streambuf->pubseekoff(end - first, std::ios::cur, std::ios::in);
+        }
+        return valid;
+    }
+
+    // walk the numbers of a JSON array as vsg::JSONParser::read_array(..) does
+    template<typename F>
+    void measure(const char* label, const std::string& buffer, size_t expectedCount, F read)
+    {
+        mem_buffer membuf;
+        std::istream input(&membuf);
+
+        double sum = 0.0;
+        size_t count = 0;
+        auto start = std::chrono::steady_clock::now();
+
+        size_t pos = 1;
+        while(pos < buffer.size() && buffer[pos] != ']')
+        {
+            if (buffer[pos] == ',' || buffer[pos] == ' ')
+            {
+                ++pos;
+                continue;
+            }
+
+            membuf.set(buffer.data() + pos, buffer.size() - pos);
+            input.clear();
+
+            double value = 0.0;
+            if (!read(input, buffer, pos, value)) break;
+
+            sum += value;
+            ++count;
+            pos += static_cast<size_t>(input.tellg());
+        }
+
+        auto duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "    " << label << " " << duration << "ms, " << (duration * 1e6) / static_cast<double>(count) << "ns per number (" << count << " numbers, sum " << sum << ")" << std::endl;
+
+        if (count != expectedCount) std::cout << "    ** only " << count << " of " << expectedCount << " numbers read" << std::endl;
+    }
+}
+
+int main(int, char**)
+{
+    constexpr size_t count = 2000000;
+
+    // accessor min/max, node matrices and animation values as exporters write them, full precision doubles past the small string buffer
+    std::mt19937 random(1);
+    std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+    std::string buffer = "[";
+    char str[64];
+    for(size_t i = 0; i < count; ++i)
+    {
+        auto result = std::to_chars(str, str + sizeof(str), distribution(random) * 0.05);
+        if (i > 0) buffer += ", ";
+        buffer.append(str, result.ptr);
+    }
+    buffer += "]";
+
+    std::cout << count << " doubles, " << buffer.size() / count << " characters per number on average" << std::endl;
+    measure("istream operator>>        ", buffer, count, read_operator);
+    measure("std::string + from_chars  ", buffer, count, read_string);
+    measure("stack buffer + from_chars ", buffer, count, read_stack);
+    measure("parser buffer from_chars  ", buffer, count, read_direct);
+
+    return 0;
+}
@@ -0,0 +1,221 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+
+// Standalone micro-benchmark of the property name dispatch used by the glTF schema classes, comparing the std::string_view compare chains
+// in gltf.cpp against compile time switch tables: an FNV-1a hash switch verified by a compare, and a switch on length, first and last character.
+// Each dispatcher maps a property name to its index, or -1 if unknown, for names drawn in random order so the branches aren't predictable.
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    // the array properties of gltf::glTF::read_array(..)
+    constexpr std::array<std::string_view, 15> arrayProperties = {
+        "extensionsUsed", "extensionsRequired", "accessors", "animations", "buffers", "bufferViews", "cameras", "materials",
+        "meshes", "nodes", "samplers", "scenes", "skins", "images", "textures"};
+
+    // the properties of a gltf::Accessor
+    constexpr std::array<std::string_view, 8> accessorProperties = {
+        "bufferView", "byteOffset", "componentType", "normalized", "count", "type", "max", "min"};
+
+    // compare chain, as used by the schema classes
+
+    template<size_t N>
+    int compareChain(const std::array<std::string_view, N>& names, std::string_view property)
+    {
+        for(size_t i = 0; i < N; ++i)
+        {
+            if (property == names[i]) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    // FNV-1a hash switch verified by a compare
+
+    constexpr uint32_t fnv1a(std::string_view str)
+    {
+        uint32_t hash = 2166136261u;
+        for(char c : str) hash = (hash ^ static_cast<uint8_t>(c)) * 16777619u;
+        return hash;
+    }
+
+    int hashArrayProperty(std::string_view property)
+    {
+        int index = -1;
+        switch(fnv1a(property))
+        {
+            case(fnv1a("extensionsUsed")): index = 0; break;
+            case(fnv1a("extensionsRequired")): index = 1; break;
+            case(fnv1a("accessors")): index = 2; break;
+            case(fnv1a("animations")): index = 3; break;
+            case(fnv1a("buffers")): index = 4; break;
+            case(fnv1a("bufferViews")): index = 5; break;
+            case(fnv1a("cameras")): index = 6; break;
+            case(fnv1a("materials")): index = 7; break;
+            case(fnv1a("meshes")): index = 8; break;
+            case(fnv1a("nodes")): index = 9; break;
+            case(fnv1a("samplers")): index = 10; break;
+            case(fnv1a("scenes")): index = 11; break;
+            case(fnv1a("skins")): index = 12; break;
+            case(fnv1a("images")): index = 13; break;
+            case(fnv1a("textures")): index = 14; break;
+            default: return -1;
+        }
+        return property == arrayProperties[index] ? index : -1;
+    }
+
+    int hashAccessorProperty(std::string_view property)
+    {
+        int index = -1;
+        switch(fnv1a(property))
+        {
+            case(fnv1a("bufferView")): index = 0; break;
+            case(fnv1a("byteOffset")): index = 1; break;
+            case(fnv1a("componentType")): index = 2; break;
+            case(fnv1a("normalized")): index = 3; break;
+            case(fnv1a("count")): index = 4; break;
+            case(fnv1a("type")): index = 5; break;
+            case(fnv1a("max")): index = 6; break;
+            case(fnv1a("min")): index = 7; break;
+            default: return -1;
+        }
+        return property == accessorProperties[index] ? index : -1;
+    }
+
+    // switch on length, first and last character, verified by a compare
+
+    constexpr uint32_t shape(size_t length, char first, char last)
+    {
+        return (static_cast<uint32_t>(length) << 16) | (static_cast<uint32_t>(static_cast<uint8_t>(first)) << 8) | static_cast<uint8_t>(last);
+    }
+
+    constexpr uint32_t shape(std::string_view str)
+    {
+        return str.empty() ? 0 : shape(str.size(), str.front(), str.back());
+    }
+
+    int shapeArrayProperty(std::string_view property)
+    {
+        int index = -1;
+        switch(shape(property))
+        {
+            case(shape("extensionsUsed")): index = 0; break;
+            case(shape("extensionsRequired")): index = 1; break;
+            case(shape("accessors")): index = 2; break;
+            case(shape("animations")): index = 3; break;
+            case(shape("buffers")): index = 4; break;
+            case(shape("bufferViews")): index = 5; break;
+            case(shape("cameras")): index = 6; break;
+            case(shape("materials")): index = 7; break;
+            case(shape("meshes")): index = 8; break;
+            case(shape("nodes")): index = 9; break;
+            case(shape("samplers")): index = 10; break;
+            case(shape("scenes")): index = 11; break;
+            case(shape("skins")): index = 12; break;
+            case(shape("images")): index = 13; break;
+            case(shape("textures")): index = 14; break;
+            default: return -1;
+        }
+        return property == arrayProperties[index] ? index : -1;
+    }
+
+    int shapeAccessorProperty(std::string_view property)
+    {
+        int index = -1;
+        switch(shape(property))
+        {
+            case(shape("bufferView")): index = 0; break;
+            case(shape("byteOffset")): index = 1; break;
+            case(shape("componentType")): index = 2; break;
+            case(shape("normalized")): index = 3; break;
+            case(shape("count")): index = 4; break;
+            case(shape("type")): index = 5; break;
+            case(shape("max")): index = 6; break;
+            case(shape("min")): index = 7; break;
+            default: return -1;
+        }
+        return property == accessorProperties[index] ? index : -1;
+    }
+
+    // names in random order, held as separate strings as the parser's property names are
+    template<size_t N>
+    std::vector<std::string> randomNames(const std::array<std::string_view, N>& names, size_t count)
+    {
+        std::mt19937 random(1);
+        std::uniform_int_distribution<size_t> distribution(0, N - 1);
+
+        std::vector<std::string> result;
+        result.reserve(count);
+        for(size_t i = 0; i < count; ++i) result.emplace_back(names[distribution(random)]);
+        return result;
+    }
+
+    template<typename F>
+    void measure(const char* label, const std::vector<std::string>& names, size_t repeats, F dispatch)
+    {
+        int64_t checksum = 0;
+        auto start = std::chrono::steady_clock::now();
+        for(size_t r = 0; r < repeats; ++r)
+        {
+            for(auto& name : names) checksum += dispatch(std::string_view(name));
+        }
+        auto duration = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "    " << label << " " << duration / static_cast<double>(names.size() * repeats) << "ns per lookup (checksum " << checksum << ")" << std::endl;
+    }
+}
+
+int main(int, char**)
+{
+    constexpr size_t count = 1 << 16;
+    constexpr size_t repeats = 64;
+
+    // check the tables agree with the compare chains
+    for(auto& name : arrayProperties)
+    {
+        if (hashArrayProperty(name) != compareChain(arrayProperties, name) || shapeArrayProperty(name) != compareChain(arrayProperties, name))
+        {
+            std::cerr << "array property tables disagree for " << name << std::endl;
+            return 1;
+        }
+    }
+    for(auto& name : accessorProperties)
+    {
+        if (hashAccessorProperty(name) != compareChain(accessorProperties, name) || shapeAccessorProperty(name) != compareChain(accessorProperties, name))
+        {
+            std::cerr << "accessor property tables disagree for " << name << std::endl;
+            return 1;
+        }
+    }
+
+    auto arrayNames = randomNames(arrayProperties, count);
+    std::cout << "glTF::read_array(..), " << arrayProperties.size() << " properties" << std::endl;
+    measure("string_view compare chain     ", arrayNames, repeats, [](std::string_view p) { return compareChain(arrayProperties, p); });
+    measure("FNV-1a hash switch + verify   ", arrayNames, repeats, hashArrayProperty);
+    measure("length/first/last char switch ", arrayNames, repeats, shapeArrayProperty);
+
+    auto accessorNames = randomNames(accessorProperties, count);
+    std::cout << "Accessor, " << accessorProperties.size() << " properties" << std::endl;
+    measure("string_view compare chain     ", accessorNames, repeats, [](std::string_view p) { return compareChain(accessorProperties, p); });
+    measure("FNV-1a hash switch + verify   ", accessorNames, repeats, hashAccessorProperty);
+    measure("length/first/last char switch ", accessorNames, repeats, shapeAccessorProperty);
+
+    return 0;
+}
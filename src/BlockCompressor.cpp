@@ -0,0 +1,676 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+
+#include "gltf.h"
+
+#include <vsg/io/FileSystem.h>
+#include <vsg/io/read.h>
+#include <vsg/io/write.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+using namespace vsgXchange;
+
+namespace
+{
+    using Quality = gltf::BlockCompressor::Quality;
+
+    template<int C>
+    using Color = std::array<float, C>;
+
+    // the 16 pixels of a block in rows, with C of the RGBA channels
+    template<int C>
+    using Pixels = std::array<Color<C>, 16>;
+
+    template<int C>
+    Pixels<C> pixels(const uint8_t* rgba)
+    {
+        Pixels<C> result;
+        for(size_t i = 0; i < 16; ++i)
+        {
+            for(size_t c = 0; c < C; ++c) result[i][c] = static_cast<float>(rgba[i * 4 + c]);
+        }
+        return result;
+    }
+
+    template<int C>
+    float distance2(const Color<C>& lhs, const Color<C>& rhs)
+    {
+        float d2 = 0.0f;
+        for(size_t c = 0; c < C; ++c) d2 += (lhs[c] - rhs[c]) * (lhs[c] - rhs[c]);
+        return d2;
+    }
+
+    template<int C>
+    void clampColor(Color<C>& color)
+    {
+        for(auto& value : color) value = std::clamp(value, 0.0f, 255.0f);
+    }
+
+    // initial end points, spanning the block's bounding box for FAST quality, otherwise its extent along the principal axis of its colors
+    template<int C>
+    void initialEndpoints(const Pixels<C>& block, Quality quality, Color<C>& e0, Color<C>& e1)
+    {
+        Color<C> mean{};
+        for(auto& p : block)
+        {
+            for(size_t c = 0; c < C; ++c) mean[c] += p[c] / 16.0f;
+        }
+
+        std::array<std::array<float, C>, C> covariance{};
+        for(auto& p : block)
+        {
+            for(size_t i = 0; i < C; ++i)
+            {
+                for(size_t j = 0; j < C; ++j) covariance[i][j] += (p[i] - mean[i]) * (p[j] - mean[j]);
+            }
+        }
+
+        // the channel with the largest variance, which the others are correlated against
+        size_t major = 0;
+        for(size_t c = 1; c < C; ++c)
+        {
+            if (covariance[c][c] > covariance[major][major]) major = c;
+        }
+
+        if (quality == gltf::BlockCompressor::FAST)
+        {
+            Color<C> minimum = block[0], maximum = block[0];
+            for(auto& p : block)
+            {
+                for(size_t c = 0; c < C; ++c)
+                {
+                    minimum[c] = std::min(minimum[c], p[c]);
+                    maximum[c] = std::max(maximum[c], p[c]);
+                }
+            }
+
+            // take the diagonal of the box that follows the correlation of each channel with the major one, inset by 1/16 of the box
+            for(size_t c = 0; c < C; ++c)
+            {
+                float inset = (maximum[c] - minimum[c]) / 16.0f;
+                bool flip = covariance[major][c] < 0.0f;
+                e0[c] = flip ? minimum[c] + inset : maximum[c] - inset;
+                e1[c] = flip ? maximum[c] - inset : minimum[c] + inset;
+            }
+            return;
+        }
+
+        // power iteration for the principal axis, starting from the major channel's row of the covariance
+        Color<C> axis = covariance[major];
+        for(int iteration = 0; iteration < 8; ++iteration)
+        {
+            Color<C> next{};
+            for(size_t i = 0; i < C; ++i)
+            {
+                for(size_t j = 0; j < C; ++j) next[i] += covariance[i][j] * axis[j];
+            }
+
+            float length2 = 0.0f;
+            for(auto value : next) length2 += value * value;
+            if (length2 == 0.0f) break;
+
+            float scale = 1.0f / std::sqrt(length2);
+            for(size_t c = 0; c < C; ++c) axis[c] = next[c] * scale;
+        }
+
+        float length2 = 0.0f;
+        for(auto value : axis) length2 += value * value;
+        if (length2 == 0.0f)
+        {
+            e0 = e1 = mean;
+            return;
+        }
+
+        float minimum = 0.0f, maximum = 0.0f;
+        for(auto& p : block)
+        {
+            float t = 0.0f;
+            for(size_t c = 0; c < C; ++c) t += (p[c] - mean[c]) * axis[c];
+            minimum = std::min(minimum, t);
+            maximum = std::max(maximum, t);
+        }
+
+        for(size_t c = 0; c < C; ++c)
+        {
+            e0[c] = mean[c] + axis[c] * maximum;
+            e1[c] = mean[c] + axis[c] * minimum;
+        }
+        clampColor<C>(e0);
+        clampColor<C>(e1);
+    }
+
+    // least squares end points for the pixels interpolated with the weights, from e0 at 0 to e1 at 1
+    template<int C>
+    bool refineEndpoints(const Pixels<C>& block, const std::array<float, 16>& weights, Color<C>& e0, Color<C>& e1)
+    {
+        float a = 0.0f, b = 0.0f, c = 0.0f;
+        Color<C> d0{}, d1{};
+        for(size_t i = 0; i < 16; ++i)
+        {
+            float t = weights[i], s = 1.0f - t;
+            a += s * s;
+            b += s * t;
+            c += t * t;
+            for(size_t ch = 0; ch < C; ++ch)
+            {
+                d0[ch] += s * block[i][ch];
+                d1[ch] += t * block[i][ch];
+            }
+        }
+
+        float det = a * c - b * b;
+        if (std::abs(det) < 1e-6f) return false;
+
+        for(size_t ch = 0; ch < C; ++ch)
+        {
+            e0[ch] = (c * d0[ch] - b * d1[ch]) / det;
+            e1[ch] = (a * d1[ch] - b * d0[ch]) / det;
+        }
+        clampColor<C>(e0);
+        clampColor<C>(e1);
+        return true;
+    }
+
+    int refinements(Quality quality)
+    {
+        return quality == gltf::BlockCompressor::HIGH ? 4 : (quality == gltf::BlockCompressor::NORMAL ? 1 : 0);
+    }
+
+    // BC1 colors, as used by BC1 and the color of BC3
+
+    uint16_t to565(const Color<3>& color)
+    {
+        auto r = static_cast<uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+        auto g = static_cast<uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+        auto b = static_cast<uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    std::array<int, 3> from565(uint16_t value)
+    {
+        int r = (value >> 11) & 31, g = (value >> 5) & 63, b = value & 31;
+        return {(r << 3) | (r >> 2), (g << 2) | (g >> 4), (b << 3) | (b >> 2)};
+    }
+
+    // assign the indices of the 4 color palette between c0 and c1, ordering them so c0 > c1 as required for 4 colors, returning the squared error
+    float fitColors(const Pixels<3>& block, uint16_t& c0, uint16_t& c1, uint32_t& indices)
+    {
+        if (c0 < c1) std::swap(c0, c1);
+
+        auto p0 = from565(c0), p1 = from565(c1);
+        std::array<Color<3>, 4> palette;
+        for(size_t c = 0; c < 3; ++c)
+        {
+            palette[0][c] = static_cast<float>(p0[c]);
+            palette[1][c] = static_cast<float>(p1[c]);
+            palette[2][c] = static_cast<float>((2 * p0[c] + p1[c]) / 3);
+            palette[3][c] = static_cast<float>((p0[c] + 2 * p1[c]) / 3);
+        }
+
+        // equal end points select the 3 color mode, in which index 0 is c0 so use it throughout
+        size_t numColors = c0 == c1 ? 1 : 4;
+
+        indices = 0;
+        float error = 0.0f;
+        for(size_t i = 0; i < 16; ++i)
+        {
+            uint32_t best = 0;
+            float bestError = distance2<3>(block[i], palette[0]);
+            for(uint32_t p = 1; p < numColors; ++p)
+            {
+                float e = distance2<3>(block[i], palette[p]);
+                if (e < bestError) { best = p; bestError = e; }
+            }
+            indices |= best << (i * 2);
+            error += bestError;
+        }
+        return error;
+    }
+
+    void encodeColors(const Pixels<3>& block, Quality quality, uint8_t* dest)
+    {
+        Color<3> e0, e1;
+        initialEndpoints<3>(block, quality, e0, e1);
+
+        uint16_t c0 = to565(e0), c1 = to565(e1);
+        uint32_t indices = 0;
+        float error = fitColors(block, c0, c1, indices);
+
+        static constexpr float paletteWeights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+        for(int iteration = 0; iteration < refinements(quality) && error > 0.0f; ++iteration)
+        {
+            std::array<float, 16> weights;
+            for(size_t i = 0; i < 16; ++i) weights[i] = paletteWeights[(indices >> (i * 2)) & 3];
+            if (!refineEndpoints<3>(block, weights, e0, e1)) break;
+
+            uint16_t r0 = to565(e0), r1 = to565(e1);
+            uint32_t refinedIndices = 0;
+            float refinedError = fitColors(block, r0, r1, refinedIndices);
+            if (refinedError >= error) break;
+
+            c0 = r0;
+            c1 = r1;
+            indices = refinedIndices;
+            error = refinedError;
+        }
+
+        dest[0] = static_cast<uint8_t>(c0 & 0xff);
+        dest[1] = static_cast<uint8_t>(c0 >> 8);
+        dest[2] = static_cast<uint8_t>(c1 & 0xff);
+        dest[3] = static_cast<uint8_t>(c1 >> 8);
+        for(size_t b = 0; b < 4; ++b) dest[4 + b] = static_cast<uint8_t>(indices >> (b * 8));
+    }
+
+    // BC4 channels, as used by the alpha of BC3 and the red and green of BC5
+
+    // assign the indices of the palette of a0 and a1, 8 interpolated values when a0 > a1, otherwise 6 and 0 and 255, returning the squared error
+    float fitChannel(const std::array<float, 16>& values, uint8_t a0, uint8_t a1, uint64_t& indices)
+    {
+        std::array<float, 8> palette;
+        palette[0] = a0;
+        palette[1] = a1;
+        if (a0 > a1)
+        {
+            for(int k = 1; k <= 6; ++k) palette[k + 1] = static_cast<float>(((7 - k) * a0 + k * a1) / 7);
+        }
+        else
+        {
+            for(int k = 1; k <= 4; ++k) palette[k + 1] = static_cast<float>(((5 - k) * a0 + k * a1) / 5);
+            palette[6] = 0.0f;
+            palette[7] = 255.0f;
+        }
+
+        indices = 0;
+        float error = 0.0f;
+        for(size_t i = 0; i < 16; ++i)
+        {
+            uint64_t best = 0;
+            float bestError = (values[i] - palette[0]) * (values[i] - palette[0]);
+            for(uint64_t p = 1; p < 8; ++p)
+            {
+                float e = (values[i] - palette[p]) * (values[i] - palette[p]);
+                if (e < bestError) { best = p; bestError = e; }
+            }
+            indices |= best << (i * 3);
+            error += bestError;
+        }
+        return error;
+    }
+
+    void encodeChannel(const uint8_t* rgba, size_t channel, Quality quality, uint8_t* dest)
+    {
+        std::array<float, 16> values;
+        for(size_t i = 0; i < 16; ++i) values[i] = rgba[i * 4 + channel];
+
+        auto [minimum, maximum] = std::minmax_element(values.begin(), values.end());
+        uint8_t a0 = static_cast<uint8_t>(*maximum), a1 = static_cast<uint8_t>(*minimum);
+        uint64_t indices = 0;
+        float error = fitChannel(values, a0, a1, indices);
+
+        // the 6 value palette suits blocks with a few values at 0 or 255 and the rest in a narrower range
+        if (quality != gltf::BlockCompressor::FAST && error > 0.0f)
+        {
+            float inner0 = 255.0f, inner1 = 0.0f;
+            for(auto value : values)
+            {
+                if (value == 0.0f || value == 255.0f) continue;
+                inner0 = std::min(inner0, value);
+                inner1 = std::max(inner1, value);
+            }
+
+            if (inner0 <= inner1)
+            {
+                uint8_t b0 = static_cast<uint8_t>(inner0), b1 = static_cast<uint8_t>(inner1);
+                uint64_t innerIndices = 0;
+                float innerError = fitChannel(values, b0, b1, innerIndices);
+                if (innerError < error)
+                {
+                    a0 = b0;
+                    a1 = b1;
+                    indices = innerIndices;
+                }
+            }
+        }
+
+        dest[0] = a0;
+        dest[1] = a1;
+        for(size_t b = 0; b < 6; ++b) dest[2 + b] = static_cast<uint8_t>(indices >> (b * 8));
+    }
+
+    // BC7 mode 6, a single subset of RGBA end points with 7 bits per channel and a shared bit each, and 4 bit indices
+
+    constexpr int bc7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    struct BC7Endpoint
+    {
+        std::array<uint8_t, 4> color; // 7 bits per channel
+        uint8_t pbit = 0;
+
+        int value(size_t c) const { return (color[c] << 1) | pbit; }
+    };
+
+    BC7Endpoint quantizeBC7(const Color<4>& color)
+    {
+        BC7Endpoint best;
+        float bestError = std::numeric_limits<float>::max();
+        for(uint8_t pbit = 0; pbit < 2; ++pbit)
+        {
+            BC7Endpoint endpoint;
+            endpoint.pbit = pbit;
+            float error = 0.0f;
+            for(size_t c = 0; c < 4; ++c)
+            {
+                long q = std::lround((color[c] - pbit) / 2.0f);
+                endpoint.color[c] = static_cast<uint8_t>(std::clamp(q, 0L, 127L));
+                float d = static_cast<float>(endpoint.value(c)) - color[c];
+                error += d * d;
+            }
+            if (error < bestError) { best = endpoint; bestError = error; }
+        }
+        return best;
+    }
+
+    float fitBC7(const Pixels<4>& block, const BC7Endpoint& e0, const BC7Endpoint& e1, std::array<uint8_t, 16>& indices)
+    {
+        std::array<Color<4>, 16> palette;
+        for(size_t p = 0; p < 16; ++p)
+        {
+            for(size_t c = 0; c < 4; ++c)
+            {
+                palette[p][c] = static_cast<float>(((64 - bc7Weights[p]) * e0.value(c) + bc7Weights[p] * e1.value(c) + 32) >> 6);
+            }
+        }
+
+        float error = 0.0f;
+        for(size_t i = 0; i < 16; ++i)
+        {
+            uint8_t best = 0;
+            float bestError = distance2<4>(block[i], palette[0]);
+            for(uint8_t p = 1; p < 16; ++p)
+            {
+                float e = distance2<4>(block[i], palette[p]);
+                if (e < bestError) { best = p; bestError = e; }
+            }
+            indices[i] = best;
+            error += bestError;
+        }
+        return error;
+    }
+
+    struct BitWriter
+    {
+        uint8_t* dest;
+        size_t position = 0;
+
+        void write(uint32_t value, size_t numBits)
+        {
+            for(size_t b = 0; b < numBits; ++b, ++position)
+            {
+                if ((value >> b) & 1) dest[position / 8] |= static_cast<uint8_t>(1 << (position % 8));
+            }
+        }
+    };
+
+    // image layouts
+
+    bool isSRGB(VkFormat format)
+    {
+        return format == VK_FORMAT_R8G8B8_SRGB || format == VK_FORMAT_R8G8B8A8_SRGB;
+    }
+
+    uint32_t levelSize(uint32_t size, uint32_t level)
+    {
+        return std::max(1u, size >> level);
+    }
+
+    std::string hex(uint64_t value)
+    {
+        std::ostringstream str;
+        str << std::hex;
+        str.width(16);
+        str.fill('0');
+        str << value;
+        return str.str();
+    }
+}
+
+void gltf::BlockCompressor::encodeBC1(const uint8_t* rgba, Quality quality, uint8_t* block)
+{
+    encodeColors(pixels<3>(rgba), quality, block);
+}
+
+void gltf::BlockCompressor::encodeBC3(const uint8_t* rgba, Quality quality, uint8_t* block)
+{
+    encodeChannel(rgba, 3, quality, block);
+    encodeColors(pixels<3>(rgba), quality, block + 8);
+}
+
+void gltf::BlockCompressor::encodeBC5(const uint8_t* rgba, Quality quality, uint8_t* block)
+{
+    encodeChannel(rgba, 0, quality, block);
+    encodeChannel(rgba, 1, quality, block + 8);
+}
+
+void gltf::BlockCompressor::encodeBC7(const uint8_t* rgba, Quality quality, uint8_t* block)
+{
+    auto colors = pixels<4>(rgba);
+
+    Color<4> c0, c1;
+    initialEndpoints<4>(colors, quality, c0, c1);
+
+    auto e0 = quantizeBC7(c0), e1 = quantizeBC7(c1);
+    std::array<uint8_t, 16> indices;
+    float error = fitBC7(colors, e0, e1, indices);
+
+    for(int iteration = 0; iteration < refinements(quality) && error > 0.0f; ++iteration)
+    {
+        std::array<float, 16> weights;
+        for(size_t i = 0; i < 16; ++i) weights[i] = static_cast<float>(bc7Weights[indices[i]]) / 64.0f;
+        if (!refineEndpoints<4>(colors, weights, c0, c1)) break;
+
+        auto r0 = quantizeBC7(c0), r1 = quantizeBC7(c1);
+        std::array<uint8_t, 16> refinedIndices;
+        float refinedError = fitBC7(colors, r0, r1, refinedIndices);
+        if (refinedError >= error) break;
+
+        e0 = r0;
+        e1 = r1;
+        indices = refinedIndices;
+        error = refinedError;
+    }
+
+    // the first index is stored without its top bit so swap the end points if it's set
+    if (indices[0] >= 8)
+    {
+        std::swap(e0, e1);
+        for(auto& index : indices) index = static_cast<uint8_t>(15 - index);
+    }
+
+    std::memset(block, 0, 16);
+    BitWriter writer{block};
+    writer.write(1 << 6, 7);
+    for(size_t c = 0; c < 4; ++c)
+    {
+        writer.write(e0.color[c], 7);
+        writer.write(e1.color[c], 7);
+    }
+    writer.write(e0.pbit, 1);
+    writer.write(e1.pbit, 1);
+    writer.write(indices[0], 3);
+    for(size_t i = 1; i < 16; ++i) writer.write(indices[i], 4);
+}
+
+gltf::BlockCompressor::Result gltf::BlockCompressor::compress(vsg::ref_ptr<vsg::Data> image, Usage usage, vsg::ref_ptr<const vsg::Options> options) const
+{
+    Result result{image, false};
+    if (!image || image->dimensions() != 2 || image->properties.blockWidth != 1 || image->properties.blockHeight != 1) return result;
+
+    auto format = image->properties.format;
+    bool rgb = (format == VK_FORMAT_R8G8B8_UNORM || format == VK_FORMAT_R8G8B8_SRGB) && image->valueSize() == 3;
+    bool rgba = (format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB) && image->valueSize() == 4;
+    if (!rgb && !rgba) return result;
+
+    // the compressed image's dimensions are in blocks, with each mipmap half the blocks of the one before, so the pixels must divide into whole blocks
+    uint32_t width = image->width(), height = image->height();
+    uint32_t mipLevels = std::max(1u, static_cast<uint32_t>(image->properties.mipLevels));
+    if (width == 0 || height == 0 || width % 4 != 0 || height % 4 != 0) return result;
+
+    size_t numPixels = 0;
+    size_t numBlocks = 0;
+    for(uint32_t level = 0; level < mipLevels; ++level)
+    {
+        uint32_t blocksWide = levelSize(width / 4, level), blocksHigh = levelSize(height / 4, level);
+        if (blocksWide != (levelSize(width, level) + 3) / 4 || blocksHigh != (levelSize(height, level) + 3) / 4) return result;
+
+        numPixels += static_cast<size_t>(levelSize(width, level)) * levelSize(height, level);
+        numBlocks += static_cast<size_t>(blocksWide) * blocksHigh;
+    }
+
+    // expand the source to tightly packed RGBA
+    std::vector<uint8_t> source(numPixels * 4);
+    if (image->properties.stride == image->valueSize())
+    {
+        auto src = static_cast<const uint8_t*>(image->dataPointer());
+        if (rgb) ImagePreparer::expandRGB(src, source.data(), numPixels);
+        else std::memcpy(source.data(), src, numPixels * 4);
+    }
+    else
+    {
+        for(size_t i = 0; i < numPixels; ++i)
+        {
+            auto src = static_cast<const uint8_t*>(image->dataPointer(i));
+            if (rgb) ImagePreparer::expandRGB(src, &source[i * 4], 1);
+            else std::memcpy(&source[i * 4], src, 4);
+        }
+    }
+
+    bool opaque = true;
+    for(size_t i = 0; rgba && opaque && i < static_cast<size_t>(width) * height; ++i) opaque = source[i * 4 + 3] == 255;
+
+    VkFormat compressedFormat;
+    size_t blockSize = 16;
+    void (*encode)(const uint8_t*, Quality, uint8_t*) = nullptr;
+    if (usage == NORMAL_MAP && bc5Normals)
+    {
+        compressedFormat = VK_FORMAT_BC5_UNORM_BLOCK;
+        encode = encodeBC5;
+    }
+    else if (opaque)
+    {
+        compressedFormat = isSRGB(format) ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        blockSize = 8;
+        encode = encodeBC1;
+    }
+    else if (quality == FAST)
+    {
+        compressedFormat = isSRGB(format) ? VK_FORMAT_BC3_SRGB_BLOCK : VK_FORMAT_BC3_UNORM_BLOCK;
+        encode = encodeBC3;
+    }
+    else
+    {
+        compressedFormat = isSRGB(format) ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        encode = encodeBC7;
+    }
+
+    // the cache key covers the source pixels and everything that affects their encoding
+    vsg::Path cacheFilename;
+    if (cacheDirectory)
+    {
+        uint32_t settings[] = {width, height, mipLevels, static_cast<uint32_t>(compressedFormat), static_cast<uint32_t>(quality)};
+        uint64_t key = ContentRegistry::hash(source.data(), source.size(), ContentRegistry::hash(settings, sizeof(settings)));
+        cacheFilename = cacheDirectory / "gltf_bc" / (hex(key) + ".vsgb");
+
+        if (vsg::fileExists(cacheFilename))
+        {
+            auto cached = vsg::read_cast<vsg::Data>(cacheFilename, options);
+            if (cached && cached->properties.format == compressedFormat && cached->width() == width / 4 && cached->height() == height / 4 &&
+                cached->properties.mipLevels == image->properties.mipLevels)
+            {
+                result.image = cached;
+                result.cached = true;
+                return result;
+            }
+        }
+    }
+
+    auto blocks = static_cast<uint8_t*>(vsg::allocate(numBlocks * blockSize, vsg::ALLOCATOR_AFFINITY_DATA));
+
+    const uint8_t* levelSource = source.data();
+    uint8_t* block = blocks;
+    for(uint32_t level = 0; level < mipLevels; ++level)
+    {
+        uint32_t levelWidth = levelSize(width, level), levelHeight = levelSize(height, level);
+        uint32_t blocksWide = levelSize(width / 4, level), blocksHigh = levelSize(height / 4, level);
+
+        for(uint32_t by = 0; by < blocksHigh; ++by)
+        {
+            for(uint32_t bx = 0; bx < blocksWide; ++bx)
+            {
+                // mipmaps smaller than a block repeat their edge pixels
+                uint8_t rgbaBlock[64];
+                for(uint32_t y = 0; y < 4; ++y)
+                {
+                    uint32_t sy = std::min(by * 4 + y, levelHeight - 1);
+                    for(uint32_t x = 0; x < 4; ++x)
+                    {
+                        uint32_t sx = std::min(bx * 4 + x, levelWidth - 1);
+                        std::memcpy(&rgbaBlock[(y * 4 + x) * 4], levelSource + (static_cast<size_t>(sy) * levelWidth + sx) * 4, 4);
+                    }
+                }
+
+                encode(rgbaBlock, quality, block);
+                block += blockSize;
+            }
+        }
+
+        levelSource += static_cast<size_t>(levelWidth) * levelHeight * 4;
+    }
+
+    auto properties = image->properties;
+    properties.format = compressedFormat;
+    properties.stride = static_cast<uint32_t>(blockSize);
+    properties.blockWidth = 4;
+    properties.blockHeight = 4;
+    properties.allocatorType = vsg::ALLOCATOR_TYPE_VSG_ALLOCATOR;
+
+    if (blockSize == 8) result.image = vsg::block64Array2D::create(width / 4, height / 4, reinterpret_cast<vsg::block64*>(blocks), properties);
+    else result.image = vsg::block128Array2D::create(width / 4, height / 4, reinterpret_cast<vsg::block128*>(blocks), properties);
+
+    if (cacheFilename)
+    {
+        // write to a temporary file renamed into place so concurrent loads never read a partially written file
+        auto directory = vsg::filePath(cacheFilename);
+        if (!vsg::fileExists(directory)) vsg::makeDirectory(directory);
+
+        std::ostringstream suffix;
+        suffix << "." << std::this_thread::get_id() << ".vsgb";
+        vsg::Path temporary = cacheFilename.string() + suffix.str();
+
+        if (vsg::write(result.image, temporary, options))
+        {
+            std::error_code ec;
+            std::filesystem::rename(std::filesystem::path(temporary.string()), std::filesystem::path(cacheFilename.string()), ec);
+            if (ec) std::filesystem::remove(std::filesystem::path(temporary.string()), ec);
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,237 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "gltf.h"
+
+#include <vsg/app/RecordTraversal.h>
+#include <vsg/commands/BindIndexBuffer.h>
+#include <vsg/commands/BindVertexBuffers.h>
+#include <vsg/commands/DrawIndexed.h>
+#include <vsg/io/Input.h>
+#include <vsg/io/ObjectFactory.h>
+#include <vsg/io/Output.h>
+#include <vsg/nodes/Group.h>
+#include <vsg/state/State.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vsgXchange;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// ClusterCullNode
+//
+static vsg::RegisterWithObjectFactoryProxy<gltf::ClusterCullNode> s_Register_ClusterCullNode;
+
+bool gltf::ClusterCullNode::backFacing(const vsg::dmat4& modelview) const
+{
+    if (coneCutoff >= 1.0f) return false;
+
+    // transform the cone into eye coordinates where the eye is at the origin
+    vsg::dvec3 center = modelview * bound.center;
+    vsg::dvec3 axis = modelview * (bound.center + vsg::dvec3(coneAxis)) - center;
+
+    double scale = vsg::length(axis);
+    if (scale == 0.0) return false;
+    axis = axis / scale;
+
+    return vsg::dot(center, axis) >= static_cast<double>(coneCutoff) * vsg::length(center) + bound.radius * scale;
+}
+
+void gltf::ClusterCullNode::traverse(vsg::RecordTraversal& visitor) const
+{
+    auto state = visitor.getState();
+    if (!state->intersect(bound)) return;
+    if (backFacing(state->modelviewMatrixStack.top())) return;
+
+    if (child) child->accept(visitor);
+}
+
+void gltf::ClusterCullNode::read(vsg::Input& input)
+{
+    vsg::Node::read(input);
+
+    input.read("bound", bound);
+    input.read("coneAxis", coneAxis);
+    input.read("coneCutoff", coneCutoff);
+    input.read("numTriangles", numTriangles);
+    input.read("child", child);
+}
+
+void gltf::ClusterCullNode::write(vsg::Output& output) const
+{
+    vsg::Node::write(output);
+
+    output.write("bound", bound);
+    output.write("coneAxis", coneAxis);
+    output.write("coneCutoff", coneCutoff);
+    output.write("numTriangles", numTriangles);
+    output.write("child", child);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// ClusterBuilder
+//
+std::vector<gltf::ClusterBuilder::Cluster> gltf::ClusterBuilder::build(const std::vector<uint32_t>& indices, const std::vector<vsg::vec3>& positions, bool backFaceCulling) const
+{
+    std::vector<Cluster> clusters;
+
+    size_t numTriangles = indices.size() / 3;
+    if (numTriangles == 0 || maxVertices < 3 || maxTriangles < 1) return clusters;
+
+    // the id of the cluster that last used each vertex, so new vertices can be counted without clearing a set per cluster
+    std::vector<uint32_t> lastCluster(positions.size(), std::numeric_limits<uint32_t>::max());
+
+    auto computeBounds = [&](Cluster& cluster)
+    {
+        const uint32_t* begin = indices.data() + cluster.firstIndex;
+        const uint32_t* end = begin + cluster.indexCount;
+
+        vsg::vec3 minimum = positions[*begin];
+        vsg::vec3 maximum = minimum;
+        for(auto ptr = begin; ptr != end; ++ptr)
+        {
+            auto& p = positions[*ptr];
+            for(int c = 0; c < 3; ++c)
+            {
+                minimum[c] = std::min(minimum[c], p[c]);
+                maximum[c] = std::max(maximum[c], p[c]);
+            }
+        }
+
+        vsg::dvec3 center = (vsg::dvec3(minimum) + vsg::dvec3(maximum)) * 0.5;
+        double radius = 0.0;
+        for(auto ptr = begin; ptr != end; ++ptr)
+        {
+            radius = std::max(radius, vsg::length(vsg::dvec3(positions[*ptr]) - center));
+        }
+        cluster.bound.set(center.x, center.y, center.z, radius);
+
+        if (!backFaceCulling) return;
+
+        // normal cone, the average of the triangle normals as the axis and the most divergent normal for the spread
+        std::vector<vsg::vec3> normals;
+        normals.reserve(cluster.indexCount / 3);
+        vsg::vec3 axis(0.0f, 0.0f, 0.0f);
+        for(auto ptr = begin; ptr != end; ptr += 3)
+        {
+            auto& p0 = positions[ptr[0]];
+            auto n = vsg::cross(positions[ptr[1]] - p0, positions[ptr[2]] - p0);
+            float length = vsg::length(n);
+            if (length == 0.0f) continue;
+
+            normals.push_back(n / length);
+            axis = axis + normals.back();
+        }
+
+        float axisLength = vsg::length(axis);
+        if (normals.empty() || axisLength == 0.0f) return;
+        axis = axis / axisLength;
+
+        float minDot = 1.0f;
+        for(auto& n : normals) minDot = std::min(minDot, vsg::dot(axis, n));
+
+        // cones wider than ~84 degrees cull too rarely to be worth testing
+        if (minDot <= 0.1f) return;
+
+        cluster.coneAxis = axis;
+        cluster.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+    };
+
+    Cluster cluster;
+    uint32_t clusterVertices = 0;
+    uint32_t clusterTriangles = 0;
+    uint32_t clusterID = 0;
+    for(size_t t = 0; t < numTriangles; ++t)
+    {
+        const uint32_t* triangle = &indices[t * 3];
+
+        auto countNewVertices = [&]()
+        {
+            uint32_t count = 0;
+            if (lastCluster[triangle[0]] != clusterID) ++count;
+            if (lastCluster[triangle[1]] != clusterID && triangle[1] != triangle[0]) ++count;
+            if (lastCluster[triangle[2]] != clusterID && triangle[2] != triangle[0] && triangle[2] != triangle[1]) ++count;
+            return count;
+        };
+
+        uint32_t newVertices = countNewVertices();
+        if (clusterTriangles > 0 && (clusterTriangles == maxTriangles || (clusterVertices + newVertices) > maxVertices))
+        {
+            computeBounds(cluster);
+            clusters.push_back(cluster);
+
+            cluster = Cluster();
+            cluster.firstIndex = static_cast<uint32_t>(t * 3);
+            clusterVertices = 0;
+            clusterTriangles = 0;
+            ++clusterID;
+
+            newVertices = countNewVertices();
+        }
+
+        for(int i = 0; i < 3; ++i) lastCluster[triangle[i]] = clusterID;
+        clusterVertices += newVertices;
+        ++clusterTriangles;
+        cluster.indexCount += 3;
+    }
+
+    computeBounds(cluster);
+    clusters.push_back(cluster);
+
+    return clusters;
+}
+
+vsg::ref_ptr<vsg::Node> gltf::ClusterBuilder::createClusters(const vsg::VertexIndexDraw& vid, const vsg::vec3Array& positions, bool backFaceCulling) const
+{
+    if (!vid.indices || !vid.indices->data) return {};
+
+    std::vector<uint32_t> indices;
+    if (!GeometryOptimizer::readIndices(*vid.indices->data, indices)) return {};
+
+    size_t numTriangles = indices.size() / 3;
+    if (numTriangles < minTriangles || numTriangles <= maxTriangles) return {};
+
+    for(auto index : indices)
+    {
+        if (index >= positions.size()) return {};
+    }
+
+    std::vector<vsg::vec3> vertices(positions.begin(), positions.end());
+    auto clusters = build(indices, vertices, backFaceCulling);
+
+    // bind the vertex arrays and indices once, the DrawIndexed of each cluster then draws its range of the indices
+    vsg::DataList arrays;
+    for(auto& bufferInfo : vid.arrays)
+    {
+        arrays.push_back(bufferInfo->data);
+    }
+
+    auto group = vsg::Group::create();
+    group->addChild(vsg::BindVertexBuffers::create(vid.firstBinding, arrays));
+    group->addChild(vsg::BindIndexBuffer::create(vid.indices->data));
+
+    for(auto& cluster : clusters)
+    {
+        auto cullNode = ClusterCullNode::create();
+        cullNode->bound = cluster.bound;
+        cullNode->coneAxis = cluster.coneAxis;
+        cullNode->coneCutoff = cluster.coneCutoff;
+        cullNode->numTriangles = cluster.indexCount / 3;
+        cullNode->child = vsg::DrawIndexed::create(cluster.indexCount, vid.instanceCount, cluster.firstIndex, 0, vid.firstInstance);
+        group->addChild(cullNode);
+    }
+
+    return group;
+}
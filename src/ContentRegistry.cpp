@@ -0,0 +1,197 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "gltf.h"
+
+#include <algorithm>
+#include <cstring>
+#include <typeinfo>
+
+using namespace vsgXchange;
+
+namespace
+{
+    constexpr uint64_t prime64_1 = 0x9E3779B185EBCA87ULL;
+    constexpr uint64_t prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+    constexpr uint64_t prime64_3 = 0x165667B19E3779F9ULL;
+    constexpr uint64_t prime64_4 = 0x85EBCA77C2B2AE63ULL;
+    constexpr uint64_t prime64_5 = 0x27D4EB2F165667C5ULL;
+
+    inline uint64_t rotl(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    inline uint64_t read64(const uint8_t* ptr)
+    {
+        uint64_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    inline uint32_t read32(const uint8_t* ptr)
+    {
+        uint32_t value;
+        std::memcpy(&value, ptr, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t round(uint64_t acc, uint64_t input)
+    {
+        acc += input * prime64_2;
+        acc = rotl(acc, 31);
+        return acc * prime64_1;
+    }
+
+    inline uint64_t mergeRound(uint64_t acc, uint64_t value)
+    {
+        acc ^= round(0, value);
+        return acc * prime64_1 + prime64_4;
+    }
+
+    // the data that can be hashed and compared as a single block of bytes
+    bool contiguous(const vsg::Data& data)
+    {
+        return data.dataPointer() && data.dataSize() > 0 && data.properties.stride == data.valueSize();
+    }
+
+    bool sameContents(const vsg::Data& lhs, const vsg::Data& rhs)
+    {
+        return typeid(lhs) == typeid(rhs) &&
+               lhs.properties.format == rhs.properties.format &&
+               lhs.properties.blockWidth == rhs.properties.blockWidth &&
+               lhs.properties.blockHeight == rhs.properties.blockHeight &&
+               lhs.properties.blockDepth == rhs.properties.blockDepth &&
+               lhs.properties.mipLevels == rhs.properties.mipLevels &&
+               lhs.properties.imageViewType == rhs.properties.imageViewType &&
+               lhs.width() == rhs.width() && lhs.height() == rhs.height() && lhs.depth() == rhs.depth() &&
+               lhs.dataSize() == rhs.dataSize() &&
+               std::memcmp(lhs.dataPointer(), rhs.dataPointer(), lhs.dataSize()) == 0;
+    }
+}
+
+uint64_t gltf::ContentRegistry::hash(const void* ptr, size_t size, uint64_t seed)
+{
+    auto p = static_cast<const uint8_t*>(ptr);
+    auto end = p + size;
+
+    uint64_t h;
+    if (size >= 32)
+    {
+        uint64_t v1 = seed + prime64_1 + prime64_2;
+        uint64_t v2 = seed + prime64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - prime64_1;
+
+        for(auto limit = end - 32; p <= limit; p += 32)
+        {
+            v1 = round(v1, read64(p));
+            v2 = round(v2, read64(p + 8));
+            v3 = round(v3, read64(p + 16));
+            v4 = round(v4, read64(p + 24));
+        }
+
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = mergeRound(h, v1);
+        h = mergeRound(h, v2);
+        h = mergeRound(h, v3);
+        h = mergeRound(h, v4);
+    }
+    else
+    {
+        h = seed + prime64_5;
+    }
+
+    h += static_cast<uint64_t>(size);
+
+    for(; p + 8 <= end; p += 8)
+    {
+        h ^= round(0, read64(p));
+        h = rotl(h, 27) * prime64_1 + prime64_4;
+    }
+
+    if (p + 4 <= end)
+    {
+        h ^= static_cast<uint64_t>(read32(p)) * prime64_1;
+        h = rotl(h, 23) * prime64_2 + prime64_3;
+        p += 4;
+    }
+
+    for(; p < end; ++p)
+    {
+        h ^= static_cast<uint64_t>(*p) * prime64_5;
+        h = rotl(h, 11) * prime64_1;
+    }
+
+    h ^= h >> 33;
+    h *= prime64_2;
+    h ^= h >> 29;
+    h *= prime64_3;
+    h ^= h >> 32;
+
+    return h;
+}
+
+vsg::ref_ptr<vsg::Data> gltf::ContentRegistry::share(vsg::ref_ptr<vsg::Data> data)
+{
+    if (!data || !contiguous(*data)) return data;
+
+    // hash the dimensions along with the contents so images of the same bytes but different shapes don't collide
+    uint32_t dimensions[4] = {data->width(), data->height(), data->depth(), static_cast<uint32_t>(data->properties.format)};
+    uint64_t key = hash(data->dataPointer(), data->dataSize(), hash(dimensions, sizeof(dimensions)));
+
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    if (_registered.size() >= _pruneSize) _prune();
+
+    auto& candidates = _registered[key];
+    for(auto itr = candidates.begin(); itr != candidates.end();)
+    {
+        auto candidate = itr->ref_ptr();
+        if (!candidate)
+        {
+            // no longer referenced by any scene graph
+            itr = candidates.erase(itr);
+            continue;
+        }
+
+        if (candidate == data) return data;
+
+        if (sameContents(*candidate, *data))
+        {
+            ++numShared;
+            bytesSaved += data->dataSize();
+            return candidate;
+        }
+        ++itr;
+    }
+
+    candidates.emplace_back(data);
+    return data;
+}
+
+void gltf::ContentRegistry::prune()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    _prune();
+}
+
+void gltf::ContentRegistry::_prune()
+{
+    for(auto itr = _registered.begin(); itr != _registered.end();)
+    {
+        auto& candidates = itr->second;
+        candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [](const vsg::observer_ptr<vsg::Data>& candidate) { return !candidate.ref_ptr(); }), candidates.end());
+
+        if (candidates.empty()) itr = _registered.erase(itr);
+        else ++itr;
+    }
+
+    _pruneSize = std::max(size_t(1024), _registered.size() * 2);
+}
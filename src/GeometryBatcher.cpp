@@ -0,0 +1,282 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "gltf.h"
+
+#include <vsg/nodes/VertexDraw.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace vsgXchange;
+
+namespace
+{
+    // the arrays and range of vertices or indices drawn by a VertexIndexDraw or VertexDraw
+    struct DrawRange
+    {
+        const vsg::BufferInfoList* arrays = nullptr;
+        const vsg::Data* indices = nullptr;
+        uint32_t firstBinding = 0;
+        uint32_t first = 0;
+        uint32_t count = 0;
+        int32_t vertexOffset = 0;
+        uint32_t instanceCount = 0;
+
+        explicit DrawRange(const vsg::Command& draw)
+        {
+            if (auto vid = draw.cast<vsg::VertexIndexDraw>())
+            {
+                if (!vid->indices || !vid->indices->data) return;
+
+                arrays = &vid->arrays;
+                indices = vid->indices->data.get();
+                firstBinding = vid->firstBinding;
+                first = vid->firstIndex;
+                count = vid->indexCount;
+                vertexOffset = vid->vertexOffset;
+                instanceCount = vid->instanceCount;
+            }
+            else if (auto vd = draw.cast<vsg::VertexDraw>())
+            {
+                arrays = &vd->arrays;
+                firstBinding = vd->firstBinding;
+                first = vd->firstVertex;
+                count = vd->vertexCount;
+                instanceCount = vd->instanceCount;
+            }
+        }
+
+        const vsg::Data* array(int i) const
+        {
+            if (!arrays || i < 0 || static_cast<size_t>(i) >= arrays->size() || !(*arrays)[i]) return nullptr;
+            return (*arrays)[i]->data.get();
+        }
+
+        // the vertex indices drawn, relative to the start of the arrays
+        bool vertexIndices(std::vector<uint32_t>& result) const
+        {
+            result.clear();
+            if (indices)
+            {
+                std::vector<uint32_t> values;
+                if (!gltf::GeometryOptimizer::readIndices(*indices, values) || static_cast<size_t>(first) + count > values.size()) return false;
+
+                result.reserve(count);
+                for(uint32_t i = first; i < first + count; ++i)
+                {
+                    int64_t index = static_cast<int64_t>(values[i]) + vertexOffset;
+                    if (index < 0) return false;
+                    result.push_back(static_cast<uint32_t>(index));
+                }
+            }
+            else
+            {
+                result.reserve(count);
+                for(uint32_t i = first; i < first + count; ++i) result.push_back(i);
+            }
+            return true;
+        }
+    };
+}
+
+uint32_t gltf::GeometryBatcher::numVertices(const Primitive& primitive)
+{
+    auto positions = DrawRange(*primitive.draw).array(primitive.positionArray);
+    return positions ? static_cast<uint32_t>(positions->valueCount()) : 0;
+}
+
+std::string gltf::GeometryBatcher::layout(const Primitive& primitive) const
+{
+    if (!primitive.draw) return {};
+
+    DrawRange range(*primitive.draw);
+    if (!range.arrays || range.instanceCount != 1 || range.count == 0) return {};
+
+    // positions and normals are transformed so must be vec3Array
+    auto positions = range.array(primitive.positionArray);
+    if (!positions || !dynamic_cast<const vsg::vec3Array*>(positions)) return {};
+    if (primitive.normalArray >= 0 && !dynamic_cast<const vsg::vec3Array*>(range.array(primitive.normalArray))) return {};
+
+    size_t vertexCount = positions->valueCount();
+    if (vertexCount > maxPrimitiveVertices) return {};
+
+    std::vector<uint32_t> indices;
+    if (!range.vertexIndices(indices)) return {};
+    for(auto index : indices)
+    {
+        if (index >= vertexCount) return {};
+    }
+
+    std::string signature;
+    auto append = [&signature](const void* ptr, size_t size) { signature.append(static_cast<const char*>(ptr), size); };
+
+    append(&range.firstBinding, sizeof(range.firstBinding));
+    append(&primitive.triangles, sizeof(primitive.triangles));
+    append(&primitive.positionArray, sizeof(primitive.positionArray));
+    append(&primitive.normalArray, sizeof(primitive.normalArray));
+
+    for(size_t a = 0; a < range.arrays->size(); ++a)
+    {
+        auto data = range.array(static_cast<int>(a));
+
+        // the merged arrays are tightly packed so the pipeline's vertex bindings must be too
+        if (!data || data->properties.stride != data->valueSize()) return {};
+
+        uint32_t valueSize = static_cast<uint32_t>(data->valueSize());
+        if (data->valueCount() == vertexCount)
+        {
+            if (!createCompatibleArray(const_cast<vsg::Data&>(*data), 0)) return {};
+
+            signature.push_back('v');
+            append(&valueSize, sizeof(valueSize));
+        }
+        else if (data->valueCount() == 1)
+        {
+            // per instance values such as the default color must match to be shared
+            signature.push_back('i');
+            append(&valueSize, sizeof(valueSize));
+            append(data->dataPointer(), valueSize);
+        }
+        else
+        {
+            return {};
+        }
+    }
+
+    return signature;
+}
+
+vsg::ref_ptr<vsg::VertexIndexDraw> gltf::GeometryBatcher::merge(const std::vector<Primitive>& primitives) const
+{
+    if (primitives.empty()) return {};
+
+    DrawRange firstRange(*primitives.front().draw);
+    int positionArray = primitives.front().positionArray;
+    int normalArray = primitives.front().normalArray;
+
+    size_t totalVertices = 0;
+    size_t totalIndices = 0;
+    for(auto& primitive : primitives)
+    {
+        totalVertices += numVertices(primitive);
+        totalIndices += DrawRange(*primitive.draw).count;
+    }
+
+    // the range of uint32 indices
+    if (totalVertices > std::numeric_limits<uint32_t>::max()) return {};
+
+    // per vertex arrays are concatenated, per instance arrays shared
+    size_t firstVertexCount = numVertices(primitives.front());
+    vsg::DataList arrays;
+    std::vector<bool> perVertex;
+    for(size_t a = 0; a < firstRange.arrays->size(); ++a)
+    {
+        auto data = (*firstRange.arrays)[a]->data;
+        if (data->valueCount() == firstVertexCount)
+        {
+            auto merged = createCompatibleArray(*data, static_cast<uint32_t>(totalVertices));
+            if (!merged) return {};
+
+            arrays.push_back(merged);
+            perVertex.push_back(true);
+        }
+        else
+        {
+            arrays.push_back(data);
+            perVertex.push_back(false);
+        }
+    }
+
+    auto positions = arrays[positionArray].cast<vsg::vec3Array>();
+    auto normals = normalArray >= 0 ? arrays[normalArray].cast<vsg::vec3Array>() : vsg::ref_ptr<vsg::vec3Array>();
+
+    std::vector<uint32_t> indices;
+    indices.reserve(totalIndices);
+
+    size_t baseVertex = 0;
+    std::vector<uint32_t> primitiveIndices;
+    for(auto& primitive : primitives)
+    {
+        DrawRange range(*primitive.draw);
+        size_t vertexCount = numVertices(primitive);
+
+        auto sourceNormals = normals ? range.array(normalArray)->cast<vsg::vec3Array>() : nullptr;
+
+        // normals are written by the transform below
+        for(size_t a = 0; a < arrays.size(); ++a)
+        {
+            if (perVertex[a] && !(sourceNormals && static_cast<int>(a) == normalArray)) copyValues(*range.array(static_cast<int>(a)), 0, *arrays[a], baseVertex, vertexCount);
+        }
+
+        auto& m = primitive.matrix;
+        for(size_t v = baseVertex; v < baseVertex + vertexCount; ++v)
+        {
+            auto& p = positions->at(v);
+            p = vsg::vec3(m * vsg::dvec3(p));
+        }
+
+        if (sourceNormals && vertexCount > 0)
+        {
+            // transform from the source normals into this primitive's range of the merged normals, TransformFlattener::transformNormals(..) isn't in place
+            auto destNormals = vsg::vec3Array::create(normals, static_cast<uint32_t>(baseVertex * sizeof(vsg::vec3)), static_cast<uint32_t>(sizeof(vsg::vec3)), static_cast<uint32_t>(vertexCount));
+            TransformFlattener::transformNormals(m, *sourceNormals, *destNormals);
+        }
+
+        range.vertexIndices(primitiveIndices);
+
+        // a mirroring matrix reverses the winding of the triangles so swap it back to keep the front faces
+        vsg::dvec3 c0(m[0][0], m[0][1], m[0][2]), c1(m[1][0], m[1][1], m[1][2]), c2(m[2][0], m[2][1], m[2][2]);
+        bool mirrored = primitive.triangles && vsg::dot(vsg::cross(c0, c1), c2) < 0.0;
+
+        if (mirrored)
+        {
+            for(size_t i = 0; i + 2 < primitiveIndices.size(); i += 3)
+            {
+                indices.push_back(static_cast<uint32_t>(baseVertex + primitiveIndices[i]));
+                indices.push_back(static_cast<uint32_t>(baseVertex + primitiveIndices[i + 2]));
+                indices.push_back(static_cast<uint32_t>(baseVertex + primitiveIndices[i + 1]));
+            }
+        }
+        else
+        {
+            for(auto index : primitiveIndices) indices.push_back(static_cast<uint32_t>(baseVertex + index));
+        }
+
+        baseVertex += vertexCount;
+    }
+
+    for(auto& data : arrays) data->dirty();
+
+    vsg::ref_ptr<vsg::Data> indexArray;
+    if (totalVertices < 0xffff)
+    {
+        auto ushortIndices = vsg::ushortArray::create(static_cast<uint32_t>(indices.size()));
+        for(size_t i = 0; i < indices.size(); ++i) ushortIndices->at(i) = static_cast<uint16_t>(indices[i]);
+        indexArray = ushortIndices;
+    }
+    else
+    {
+        auto uintIndices = vsg::uintArray::create(static_cast<uint32_t>(indices.size()));
+        std::copy(indices.begin(), indices.end(), uintIndices->begin());
+        indexArray = uintIndices;
+    }
+
+    auto vid = vsg::VertexIndexDraw::create();
+    vid->firstBinding = firstRange.firstBinding;
+    vid->assignArrays(arrays);
+    vid->assignIndices(indexArray);
+    vid->indexCount = static_cast<uint32_t>(indices.size());
+    vid->instanceCount = 1;
+
+    return vid;
+}
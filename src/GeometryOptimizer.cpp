@@ -0,0 +1,503 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "gltf.h"
+
+#include <vsg/nodes/VertexIndexDraw.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace vsgXchange;
+
+namespace
+{
+    constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
+    // scoring constants from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+    constexpr float cacheDecayPower = 1.5f;
+    constexpr float lastTriangleScore = 0.75f;
+    constexpr float valenceBoostScale = 2.0f;
+    constexpr float valenceBoostPower = 0.5f;
+    constexpr uint32_t maxValenceScore = 64;
+
+    struct VertexScores
+    {
+        std::vector<float> cache;
+        std::vector<float> valence;
+
+        explicit VertexScores(uint32_t cacheSize) :
+            cache(cacheSize),
+            valence(maxValenceScore)
+        {
+            for(uint32_t i = 0; i < cacheSize; ++i)
+            {
+                if (i < 3) cache[i] = lastTriangleScore;
+                else cache[i] = std::pow(1.0f - static_cast<float>(i - 3) / static_cast<float>(cacheSize - 3), cacheDecayPower);
+            }
+
+            for(uint32_t i = 1; i < maxValenceScore; ++i)
+            {
+                valence[i] = valenceBoostScale * std::pow(static_cast<float>(i), -valenceBoostPower);
+            }
+        }
+
+        float operator()(int32_t cachePosition, uint32_t remainingValence) const
+        {
+            if (remainingValence == 0) return -1.0f;
+
+            float score = (cachePosition >= 0) ? cache[cachePosition] : 0.0f;
+            if (remainingValence < maxValenceScore) score += valence[remainingValence];
+            else score += valenceBoostScale * std::pow(static_cast<float>(remainingValence), -valenceBoostPower);
+            return score;
+        }
+    };
+
+    // FIFO cache simulation using timestamps, a vertex is in the cache if it was added within the last fifoSize misses
+    struct FifoCache
+    {
+        std::vector<uint32_t> timestamps;
+        uint32_t fifoSize;
+        uint32_t time;
+
+        FifoCache(size_t numVertices, uint32_t in_fifoSize) :
+            timestamps(numVertices, 0),
+            fifoSize(in_fifoSize),
+            time(in_fifoSize + 1) {}
+
+        uint32_t misses(const uint32_t* triangle)
+        {
+            uint32_t count = 0;
+            for(int i = 0; i < 3; ++i)
+            {
+                uint32_t v = triangle[i];
+                if ((time - timestamps[v]) > fifoSize)
+                {
+                    timestamps[v] = time++;
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        void reset() { time += fifoSize + 1; }
+    };
+
+    // copy the elements of data to their new positions in a new array, keeping the stride of strided views as the pipeline's vertex bindings
+    // were set up with it. The source may be a view of a buffer shared with other loads so is never written to.
+    vsg::ref_ptr<vsg::Data> remapArray(vsg::Data& data, const std::vector<uint32_t>& remap)
+    {
+        size_t valueSize = data.valueSize();
+        size_t valueCount = data.valueCount();
+        uint32_t stride = data.properties.stride;
+
+        vsg::ref_ptr<vsg::Data> remapped;
+        if (stride > valueSize)
+        {
+            auto storage = vsg::ubyteArray::create(static_cast<uint32_t>(valueCount * stride));
+            remapped = gltf::createArrayView(data, storage, 0, stride, static_cast<uint32_t>(valueCount));
+        }
+        else
+        {
+            remapped = gltf::createCompatibleArray(data, static_cast<uint32_t>(valueCount));
+        }
+        if (!remapped) return {};
+
+        for(size_t i = 0; i < valueCount; ++i)
+        {
+            gltf::copyValues(data, i, *remapped, remap[i], 1);
+        }
+
+        remapped->dirty();
+        return remapped;
+    }
+}
+
+gltf::GeometryOptimizer::Statistics& gltf::GeometryOptimizer::Statistics::operator+=(const Statistics& rhs)
+{
+    numPrimitives += rhs.numPrimitives;
+    numNarrowed += rhs.numNarrowed;
+    numTriangles += rhs.numTriangles;
+    missesBefore += rhs.missesBefore;
+    missesAfter += rhs.missesAfter;
+    return *this;
+}
+
+size_t gltf::GeometryOptimizer::cacheMisses(const std::vector<uint32_t>& indices, size_t numVertices, uint32_t fifoSize)
+{
+    FifoCache cache(numVertices, fifoSize);
+
+    size_t misses = 0;
+    for(size_t i = 0; (i + 2) < indices.size(); i += 3)
+    {
+        misses += cache.misses(&indices[i]);
+    }
+    return misses;
+}
+
+void gltf::GeometryOptimizer::optimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize)
+{
+    size_t numTriangles = indices.size() / 3;
+    if (numTriangles < 2 || cacheSize < 4) return;
+
+    VertexScores scoring(cacheSize);
+
+    // triangles adjacent to each vertex, valence counts the triangles not yet emitted and the first valence entries of each vertex's adjacency are those triangles
+    std::vector<uint32_t> valence(numVertices, 0);
+    for(auto v : indices) ++valence[v];
+
+    std::vector<uint32_t> offsets(numVertices + 1, 0);
+    for(size_t v = 0; v < numVertices; ++v) offsets[v + 1] = offsets[v] + valence[v];
+
+    std::vector<uint32_t> adjacency(indices.size());
+    {
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for(size_t i = 0; i < indices.size(); ++i)
+        {
+            adjacency[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+        }
+    }
+
+    std::vector<int32_t> cachePosition(numVertices, -1);
+    std::vector<float> vertexScore(numVertices);
+    for(size_t v = 0; v < numVertices; ++v) vertexScore[v] = scoring(-1, valence[v]);
+
+    std::vector<float> triangleScore(numTriangles);
+    uint32_t best = invalid_index;
+    float bestScore = -1.0f;
+    for(size_t t = 0; t < numTriangles; ++t)
+    {
+        const uint32_t* triangle = &indices[t * 3];
+        triangleScore[t] = vertexScore[triangle[0]] + vertexScore[triangle[1]] + vertexScore[triangle[2]];
+        if (triangleScore[t] > bestScore)
+        {
+            bestScore = triangleScore[t];
+            best = static_cast<uint32_t>(t);
+        }
+    }
+
+    std::vector<uint8_t> emitted(numTriangles, 0);
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    std::vector<uint32_t> cache, newCache;
+    cache.reserve(cacheSize + 3);
+    newCache.reserve(cacheSize + 3);
+
+    size_t nextUnemitted = 0;
+    while (output.size() < indices.size())
+    {
+        if (best == invalid_index)
+        {
+            // dead end, no triangles adjacent to the cache remain so restart from the next triangle in the original order
+            while (emitted[nextUnemitted]) ++nextUnemitted;
+            best = static_cast<uint32_t>(nextUnemitted);
+        }
+
+        const uint32_t* triangle = &indices[best * 3];
+        output.insert(output.end(), triangle, triangle + 3);
+        emitted[best] = 1;
+
+        // remove the triangle from its vertices' adjacency
+        for(int i = 0; i < 3; ++i)
+        {
+            uint32_t v = triangle[i];
+            uint32_t* begin = &adjacency[offsets[v]];
+            uint32_t* end = begin + valence[v];
+            auto itr = std::find(begin, end, best);
+            if (itr != end)
+            {
+                *itr = *(end - 1);
+                --valence[v];
+            }
+        }
+
+        // move the triangle's vertices to the front of the LRU cache
+        newCache.clear();
+        for(int i = 0; i < 3; ++i)
+        {
+            if (std::find(newCache.begin(), newCache.end(), triangle[i]) == newCache.end()) newCache.push_back(triangle[i]);
+        }
+        for(auto v : cache)
+        {
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2]) newCache.push_back(v);
+        }
+
+        // update the scores of the vertices in the cache, including any just evicted, and of their remaining triangles
+        for(size_t i = 0; i < newCache.size(); ++i)
+        {
+            uint32_t v = newCache[i];
+            cachePosition[v] = (i < cacheSize) ? static_cast<int32_t>(i) : -1;
+            vertexScore[v] = scoring(cachePosition[v], valence[v]);
+        }
+
+        best = invalid_index;
+        bestScore = -1.0f;
+        for(auto v : newCache)
+        {
+            for(uint32_t a = offsets[v]; a < offsets[v] + valence[v]; ++a)
+            {
+                uint32_t t = adjacency[a];
+                const uint32_t* tv = &indices[t * 3];
+                float score = vertexScore[tv[0]] + vertexScore[tv[1]] + vertexScore[tv[2]];
+                triangleScore[t] = score;
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = t;
+                }
+            }
+        }
+
+        if (newCache.size() > cacheSize) newCache.resize(cacheSize);
+        cache.swap(newCache);
+    }
+
+    indices.swap(output);
+}
+
+void gltf::GeometryOptimizer::optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<vsg::vec3>& positions, uint32_t fifoSize, float threshold)
+{
+    size_t numTriangles = indices.size() / 3;
+    if (numTriangles < 2) return;
+
+    // hard boundaries where the vertex cache order starts afresh, every vertex of the triangle missing the cache
+    std::vector<size_t> hardBoundaries;
+    {
+        FifoCache cache(positions.size(), fifoSize);
+        for(size_t t = 0; t < numTriangles; ++t)
+        {
+            if (cache.misses(&indices[t * 3]) == 3 || t == 0) hardBoundaries.push_back(t);
+        }
+        hardBoundaries.push_back(numTriangles);
+    }
+
+    // soft boundaries within each hard cluster, splitting wherever the cluster so far has an ACMR within threshold of the whole hard cluster
+    std::vector<size_t> clusters;
+    {
+        FifoCache cache(positions.size(), fifoSize);
+        for(size_t h = 0; (h + 1) < hardBoundaries.size(); ++h)
+        {
+            size_t start = hardBoundaries[h];
+            size_t end = hardBoundaries[h + 1];
+
+            cache.reset();
+            size_t clusterMisses = 0;
+            for(size_t t = start; t < end; ++t) clusterMisses += cache.misses(&indices[t * 3]);
+
+            double clusterThreshold = threshold * static_cast<double>(clusterMisses) / static_cast<double>(end - start);
+
+            cache.reset();
+            size_t misses = 0;
+            size_t last = start;
+            clusters.push_back(start);
+            for(size_t t = start; (t + 1) < end; ++t)
+            {
+                misses += cache.misses(&indices[t * 3]);
+                if (static_cast<double>(misses) / static_cast<double>(t + 1 - last) <= clusterThreshold)
+                {
+                    clusters.push_back(t + 1);
+                    last = t + 1;
+                    misses = 0;
+                    cache.reset();
+                }
+            }
+        }
+        clusters.push_back(numTriangles);
+    }
+
+    size_t numClusters = clusters.size() - 1;
+    if (numClusters < 2) return;
+
+    // area weighted centroid and normal of each cluster, and the centroid of the whole mesh
+    std::vector<vsg::vec3> centroids(numClusters);
+    std::vector<vsg::vec3> normals(numClusters);
+    vsg::vec3 meshCentroid(0.0f, 0.0f, 0.0f);
+    float meshArea = 0.0f;
+    for(size_t c = 0; c < numClusters; ++c)
+    {
+        vsg::vec3 centroid(0.0f, 0.0f, 0.0f);
+        vsg::vec3 normal(0.0f, 0.0f, 0.0f);
+        float clusterArea = 0.0f;
+        for(size_t t = clusters[c]; t < clusters[c + 1]; ++t)
+        {
+            const vsg::vec3& p0 = positions[indices[t * 3]];
+            const vsg::vec3& p1 = positions[indices[t * 3 + 1]];
+            const vsg::vec3& p2 = positions[indices[t * 3 + 2]];
+
+            vsg::vec3 n = vsg::cross(p1 - p0, p2 - p0);
+            float area = vsg::length(n);
+
+            centroid = centroid + (p0 + p1 + p2) * (area / 3.0f);
+            normal = normal + n;
+            clusterArea += area;
+        }
+
+        meshCentroid = meshCentroid + centroid;
+        meshArea += clusterArea;
+
+        centroids[c] = (clusterArea > 0.0f) ? centroid / clusterArea : positions[indices[clusters[c] * 3]];
+        float normalLength = vsg::length(normal);
+        normals[c] = (normalLength > 0.0f) ? normal / normalLength : normal;
+    }
+    if (meshArea > 0.0f) meshCentroid = meshCentroid / meshArea;
+
+    // draw the clusters that face away from the centre and are furthest out first as they are most likely to occlude the rest of the mesh
+    std::vector<float> sortKeys(numClusters);
+    for(size_t c = 0; c < numClusters; ++c)
+    {
+        sortKeys[c] = vsg::dot(centroids[c] - meshCentroid, normals[c]);
+    }
+
+    std::vector<uint32_t> order(numClusters);
+    for(size_t c = 0; c < numClusters; ++c) order[c] = static_cast<uint32_t>(c);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t lhs, uint32_t rhs) { return sortKeys[lhs] > sortKeys[rhs]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for(auto c : order)
+    {
+        output.insert(output.end(), indices.begin() + clusters[c] * 3, indices.begin() + clusters[c + 1] * 3);
+    }
+    indices.swap(output);
+}
+
+std::vector<uint32_t> gltf::GeometryOptimizer::optimizeVertexFetch(std::vector<uint32_t>& indices, size_t numVertices)
+{
+    std::vector<uint32_t> remap(numVertices, invalid_index);
+
+    uint32_t next = 0;
+    for(auto& v : indices)
+    {
+        if (remap[v] == invalid_index) remap[v] = next++;
+        v = remap[v];
+    }
+
+    // vertices not referenced by the indices go at the end
+    for(auto& r : remap)
+    {
+        if (r == invalid_index) r = next++;
+    }
+
+    return remap;
+}
+
+bool gltf::GeometryOptimizer::readIndices(const vsg::Data& data, std::vector<uint32_t>& indices)
+{
+    if (auto uiArray = dynamic_cast<const vsg::uintArray*>(&data)) indices.assign(uiArray->begin(), uiArray->end());
+    else if (auto usArray = dynamic_cast<const vsg::ushortArray*>(&data)) indices.assign(usArray->begin(), usArray->end());
+    else if (auto ubArray = dynamic_cast<const vsg::ubyteArray*>(&data)) indices.assign(ubArray->begin(), ubArray->end());
+    else return false;
+
+    return true;
+}
+
+bool gltf::GeometryOptimizer::optimize(vsg::VertexIndexDraw& vid, const vsg::vec3Array* positions, bool reorderVertices, Statistics& statistics) const
+{
+    if (!vid.indices || !vid.indices->data) return false;
+
+    std::vector<uint32_t> indices;
+    if (!readIndices(*vid.indices->data, indices)) return false;
+
+    bool uintIndices = vid.indices->data->valueSize() == sizeof(uint32_t);
+
+    if (indices.empty() || (indices.size() % 3) != 0) return false;
+
+    // the vertices are only reordered when all the per vertex arrays have the same count, arrays of a single value being per instance
+    size_t numVertices = 0;
+    bool consistentArrays = true;
+    for(auto& bufferInfo : vid.arrays)
+    {
+        if (!bufferInfo || !bufferInfo->data || bufferInfo->data->valueCount() <= 1) continue;
+
+        size_t count = bufferInfo->data->valueCount();
+        if (numVertices != 0 && count != numVertices) consistentArrays = false;
+        numVertices = std::max(numVertices, count);
+    }
+
+    uint32_t maxIndex = *std::max_element(indices.begin(), indices.end());
+    if (numVertices == 0)
+    {
+        numVertices = static_cast<size_t>(maxIndex) + 1;
+        consistentArrays = false;
+    }
+    if (maxIndex >= numVertices) return false;
+    if (positions && positions->size() != numVertices) positions = nullptr;
+
+    Statistics local;
+    local.numPrimitives = 1;
+    local.numTriangles = indices.size() / 3;
+    local.missesBefore = cacheMisses(indices, numVertices, fifoSize);
+
+    if (vertexCache)
+    {
+        optimizeVertexCache(indices, numVertices, cacheSize);
+    }
+
+    if (overdraw && positions)
+    {
+        std::vector<vsg::vec3> vertices(positions->begin(), positions->end());
+        optimizeOverdraw(indices, vertices, fifoSize, overdrawThreshold);
+    }
+
+    if (vertexFetch && reorderVertices && consistentArrays)
+    {
+        auto reordered = indices;
+        auto remap = optimizeVertexFetch(reordered, numVertices);
+
+        vsg::DataList arrays;
+        bool remapped = true;
+        for(auto& bufferInfo : vid.arrays)
+        {
+            vsg::ref_ptr<vsg::Data> data = bufferInfo ? bufferInfo->data : vsg::ref_ptr<vsg::Data>();
+            if (data && data->valueCount() == numVertices)
+            {
+                data = remapArray(*data, remap);
+                if (!data) remapped = false;
+            }
+            arrays.push_back(data);
+        }
+
+        // only adopt the reordered indices if all the arrays could be reordered with them
+        if (remapped)
+        {
+            indices.swap(reordered);
+            vid.assignArrays(arrays);
+        }
+    }
+
+    local.missesAfter = cacheMisses(indices, numVertices, fifoSize);
+
+    // 0xffff is left free as it's the primitive restart value for uint16 indices
+    vsg::ref_ptr<vsg::Data> newIndices;
+    if (numVertices < 0xffff && (narrowIndices || !uintIndices))
+    {
+        auto usArray = vsg::ushortArray::create(static_cast<uint32_t>(indices.size()));
+        std::copy(indices.begin(), indices.end(), usArray->begin());
+        newIndices = usArray;
+        if (uintIndices) local.numNarrowed = 1;
+    }
+    else
+    {
+        auto uiArray = vsg::uintArray::create(static_cast<uint32_t>(indices.size()));
+        std::copy(indices.begin(), indices.end(), uiArray->begin());
+        newIndices = uiArray;
+    }
+
+    vid.assignIndices(newIndices);
+    vid.indexCount = static_cast<uint32_t>(indices.size());
+
+    statistics += local;
+
+    return true;
+}
@@ -0,0 +1,354 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+
+#include "gltf.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSSE3__) || defined(__AVX__)
+#    include <tmmintrin.h>
+#    define GLTF_IMAGE_PREPARER_SSSE3 1
+#endif
+
+using namespace vsgXchange;
+
+namespace
+{
+    bool isSRGB(VkFormat format)
+    {
+        return format == VK_FORMAT_R8G8B8_SRGB || format == VK_FORMAT_R8G8B8A8_SRGB;
+    }
+
+    const std::array<float, 256>& srgbToLinear()
+    {
+        static const std::array<float, 256> table = []()
+        {
+            std::array<float, 256> values;
+            for(size_t i = 0; i < values.size(); ++i)
+            {
+                double c = static_cast<double>(i) / 255.0;
+                values[i] = static_cast<float>(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+            }
+            return values;
+        }();
+        return table;
+    }
+
+    // linear values at the midpoints between successive sRGB values, so the nearest sRGB value is found by a binary search
+    const std::array<float, 255>& srgbThresholds()
+    {
+        static const std::array<float, 255> table = []()
+        {
+            std::array<float, 255> values;
+            for(size_t i = 0; i < values.size(); ++i)
+            {
+                double c = (static_cast<double>(i) + 0.5) / 255.0;
+                values[i] = static_cast<float>(c <= 0.04045 ? c / 12.92 : std::pow((c + 0.055) / 1.055, 2.4));
+            }
+            return values;
+        }();
+        return table;
+    }
+
+    uint8_t linearToSRGB(float value)
+    {
+        auto& thresholds = srgbThresholds();
+        return static_cast<uint8_t>(std::upper_bound(thresholds.begin(), thresholds.end(), value) - thresholds.begin());
+    }
+
+    uint8_t linearToUNorm(float value)
+    {
+        return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+    }
+
+    double besselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for(int k = 1; k < 32 && term > sum * 1e-12; ++k)
+        {
+            double t = x / (2.0 * k);
+            term *= t * t;
+            sum += term;
+        }
+        return sum;
+    }
+
+    // filter kernel with x in pixels of the level being generated
+    double kernel(gltf::ImagePreparer::Filter filter, double x)
+    {
+        if (filter == gltf::ImagePreparer::BOX) return std::abs(x) < 0.5 ? 1.0 : 0.0;
+
+        constexpr double radius = 3.0;
+        constexpr double alpha = 4.0;
+        constexpr double pi = 3.14159265358979323846;
+
+        if (std::abs(x) >= radius) return 0.0;
+
+        double sinc = x == 0.0 ? 1.0 : std::sin(pi * x) / (pi * x);
+        double r = x / radius;
+        return sinc * besselI0(alpha * std::sqrt(1.0 - r * r)) / besselI0(alpha);
+    }
+
+    // the source pixels and normalized weights contributing to each destination pixel, clamping to the edge
+    struct Resampler
+    {
+        uint32_t taps = 0;
+        std::vector<uint32_t> indices;
+        std::vector<float> weights;
+
+        Resampler(gltf::ImagePreparer::Filter filter, uint32_t srcSize, uint32_t destSize)
+        {
+            double scale = static_cast<double>(srcSize) / static_cast<double>(destSize);
+            double support = (filter == gltf::ImagePreparer::BOX ? 0.5 : 3.0) * scale;
+            taps = static_cast<uint32_t>(std::ceil(support * 2.0)) + 1;
+
+            indices.resize(static_cast<size_t>(destSize) * taps);
+            weights.resize(static_cast<size_t>(destSize) * taps);
+
+            for(uint32_t d = 0; d < destSize; ++d)
+            {
+                double center = (static_cast<double>(d) + 0.5) * scale;
+                int64_t first = static_cast<int64_t>(std::floor(center - support));
+
+                double sum = 0.0;
+                for(uint32_t t = 0; t < taps; ++t)
+                {
+                    int64_t s = first + t;
+                    double w = kernel(filter, (static_cast<double>(s) + 0.5 - center) / scale);
+                    indices[d * taps + t] = static_cast<uint32_t>(std::clamp<int64_t>(s, 0, srcSize - 1));
+                    weights[d * taps + t] = static_cast<float>(w);
+                    sum += w;
+                }
+
+                if (sum != 0.0)
+                {
+                    for(uint32_t t = 0; t < taps; ++t) weights[d * taps + t] = static_cast<float>(weights[d * taps + t] / sum);
+                }
+            }
+        }
+    };
+
+    // resample a width x height level of linear RGBA values to destWidth x destHeight, separably with a horizontal pass into temporary rows
+    void resample(gltf::ImagePreparer::Filter filter, const std::vector<float>& src, uint32_t width, uint32_t height,
+                  std::vector<float>& dest, uint32_t destWidth, uint32_t destHeight)
+    {
+        Resampler horizontal(filter, width, destWidth);
+        Resampler vertical(filter, height, destHeight);
+
+        std::vector<float> rows(static_cast<size_t>(destWidth) * height * 4);
+        for(uint32_t y = 0; y < height; ++y)
+        {
+            const float* srcRow = &src[static_cast<size_t>(y) * width * 4];
+            float* row = &rows[static_cast<size_t>(y) * destWidth * 4];
+            for(uint32_t x = 0; x < destWidth; ++x)
+            {
+                float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+                for(uint32_t t = 0; t < horizontal.taps; ++t)
+                {
+                    const float* p = srcRow + horizontal.indices[x * horizontal.taps + t] * 4;
+                    float w = horizontal.weights[x * horizontal.taps + t];
+                    r += p[0] * w; g += p[1] * w; b += p[2] * w; a += p[3] * w;
+                }
+                row[x * 4] = r; row[x * 4 + 1] = g; row[x * 4 + 2] = b; row[x * 4 + 3] = a;
+            }
+        }
+
+        dest.assign(static_cast<size_t>(destWidth) * destHeight * 4, 0.0f);
+        for(uint32_t y = 0; y < destHeight; ++y)
+        {
+            float* destRow = &dest[static_cast<size_t>(y) * destWidth * 4];
+            for(uint32_t t = 0; t < vertical.taps; ++t)
+            {
+                const float* row = &rows[static_cast<size_t>(vertical.indices[y * vertical.taps + t]) * destWidth * 4];
+                float w = vertical.weights[y * vertical.taps + t];
+                if (w == 0.0f) continue;
+                for(size_t i = 0; i < static_cast<size_t>(destWidth) * 4; ++i) destRow[i] += row[i] * w;
+            }
+        }
+    }
+
+    // copy the base level to RGBA, a pixel at a time if the source is a strided view
+    void copyRGBA(const vsg::Data& image, bool rgb, uint8_t* dest)
+    {
+        size_t numPixels = static_cast<size_t>(image.width()) * image.height();
+        if (image.properties.stride == image.valueSize())
+        {
+            auto src = static_cast<const uint8_t*>(image.dataPointer());
+            if (rgb) gltf::ImagePreparer::expandRGB(src, dest, numPixels);
+            else std::memcpy(dest, src, numPixels * 4);
+        }
+        else
+        {
+            for(size_t i = 0; i < numPixels; ++i)
+            {
+                auto src = static_cast<const uint8_t*>(image.dataPointer(i));
+                if (rgb) gltf::ImagePreparer::expandRGB(src, dest + i * 4, 1);
+                else std::memcpy(dest + i * 4, src, 4);
+            }
+        }
+    }
+
+    void decodeLinear(const uint8_t* rgba, size_t numPixels, bool srgb, std::vector<float>& linear)
+    {
+        auto& toLinear = srgbToLinear();
+        linear.resize(numPixels * 4);
+        for(size_t i = 0; i < numPixels; ++i)
+        {
+            const uint8_t* p = rgba + i * 4;
+            for(size_t c = 0; c < 3; ++c) linear[i * 4 + c] = srgb ? toLinear[p[c]] : static_cast<float>(p[c]) / 255.0f;
+            linear[i * 4 + 3] = static_cast<float>(p[3]) / 255.0f;
+        }
+    }
+
+    // encode numPixels of linear RGBA to 8 bit values, numChannels per pixel
+    void encodeLinear(const float* linear, size_t numPixels, bool srgb, uint8_t* dest, size_t numChannels)
+    {
+        for(size_t i = 0; i < numPixels; ++i)
+        {
+            const float* p = linear + i * 4;
+            for(size_t c = 0; c < 3; ++c) dest[i * numChannels + c] = srgb ? linearToSRGB(p[c]) : linearToUNorm(p[c]);
+            if (numChannels == 4) dest[i * 4 + 3] = linearToUNorm(p[3]);
+        }
+    }
+}
+
+void gltf::ImagePreparer::expandRGB(const uint8_t* src, uint8_t* dest, size_t numPixels)
+{
+    size_t i = 0;
+
+#if defined(GLTF_IMAGE_PREPARER_SSSE3)
+    const __m128i shuffle = _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xff000000));
+
+    // each load reads 16 bytes for the 12 of 4 pixels, so stop while the last 4 bytes are still within src
+    for(; i + 6 <= numPixels; i += 4)
+    {
+        __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i * 4), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alpha));
+    }
+#endif
+
+    for(; i < numPixels; ++i)
+    {
+        dest[i * 4] = src[i * 3];
+        dest[i * 4 + 1] = src[i * 3 + 1];
+        dest[i * 4 + 2] = src[i * 3 + 2];
+        dest[i * 4 + 3] = 255;
+    }
+}
+
+bool gltf::ImagePreparer::supported(const vsg::Data& image)
+{
+    if (image.dimensions() != 2 || image.properties.mipLevels > 1 || image.width() == 0 || image.height() == 0) return false;
+
+    auto format = image.properties.format;
+    bool rgb = (format == VK_FORMAT_R8G8B8_UNORM || format == VK_FORMAT_R8G8B8_SRGB) && image.valueSize() == 3;
+    bool rgba = (format == VK_FORMAT_R8G8B8A8_UNORM || format == VK_FORMAT_R8G8B8A8_SRGB) && image.valueSize() == 4;
+    return rgb || rgba;
+}
+
+vsg::ref_ptr<vsg::Data> gltf::ImagePreparer::prepare(vsg::ref_ptr<vsg::Data> image) const
+{
+    if (!image || !supported(*image)) return image;
+
+    bool rgb = image->valueSize() == 3;
+
+    uint32_t width = image->width();
+    uint32_t height = image->height();
+
+    uint32_t mipLevels = 1;
+    while ((std::max(width, height) >> mipLevels) > 0) ++mipLevels;
+
+    size_t numPixels = 0;
+    for(uint32_t level = 0; level < mipLevels; ++level)
+    {
+        numPixels += static_cast<size_t>(std::max(1u, width >> level)) * std::max(1u, height >> level);
+    }
+
+    bool srgb = isSRGB(image->properties.format);
+
+    auto properties = image->properties;
+    properties.format = srgb ? VK_FORMAT_R8G8B8A8_SRGB : VK_FORMAT_R8G8B8A8_UNORM;
+    properties.stride = sizeof(vsg::ubvec4);
+    properties.mipLevels = static_cast<uint8_t>(mipLevels);
+    properties.allocatorType = vsg::ALLOCATOR_TYPE_VSG_ALLOCATOR;
+
+    auto pixels = static_cast<vsg::ubvec4*>(vsg::allocate(numPixels * sizeof(vsg::ubvec4), vsg::ALLOCATOR_AFFINITY_DATA));
+    auto prepared = vsg::ubvec4Array2D::create(width, height, pixels, properties);
+    auto dest = reinterpret_cast<uint8_t*>(pixels);
+
+    copyRGBA(*image, rgb, dest);
+
+    // each level is resampled from the linear values of the previous one, rather than its quantized values
+    size_t baseSize = static_cast<size_t>(width) * height;
+    std::vector<float> level;
+    decodeLinear(dest, baseSize, srgb, level);
+
+    std::vector<float> next;
+    uint8_t* levelDest = dest + baseSize * 4;
+    for(uint32_t l = 1; l < mipLevels; ++l)
+    {
+        uint32_t levelWidth = std::max(1u, width >> (l - 1)), levelHeight = std::max(1u, height >> (l - 1));
+        uint32_t nextWidth = std::max(1u, width >> l), nextHeight = std::max(1u, height >> l);
+
+        resample(filter, level, levelWidth, levelHeight, next, nextWidth, nextHeight);
+
+        size_t count = static_cast<size_t>(nextWidth) * nextHeight;
+        encodeLinear(next.data(), count, srgb, levelDest, 4);
+
+        levelDest += count * 4;
+        level.swap(next);
+    }
+
+    return prepared;
+}
+
+vsg::ref_ptr<vsg::Data> gltf::ImagePreparer::downscale(vsg::ref_ptr<vsg::Data> image, uint32_t width, uint32_t height)
+{
+    if (!image || !supported(*image) || width == 0 || height == 0 || (width >= image->width() && height >= image->height())) return image;
+
+    bool rgb = image->valueSize() == 3;
+
+    width = std::min(width, image->width());
+    height = std::min(height, image->height());
+
+    bool srgb = isSRGB(image->properties.format);
+
+    std::vector<uint8_t> source(static_cast<size_t>(image->width()) * image->height() * 4);
+    copyRGBA(*image, rgb, source.data());
+
+    std::vector<float> linear, scaled;
+    decodeLinear(source.data(), source.size() / 4, srgb, linear);
+    resample(KAISER, linear, image->width(), image->height(), scaled, width, height);
+
+    auto properties = image->properties;
+    properties.stride = static_cast<uint32_t>(image->valueSize());
+    properties.allocatorType = vsg::ALLOCATOR_TYPE_VSG_ALLOCATOR;
+
+    size_t numPixels = static_cast<size_t>(width) * height;
+    if (rgb)
+    {
+        auto pixels = static_cast<vsg::ubvec3*>(vsg::allocate(numPixels * sizeof(vsg::ubvec3), vsg::ALLOCATOR_AFFINITY_DATA));
+        encodeLinear(scaled.data(), numPixels, srgb, reinterpret_cast<uint8_t*>(pixels), 3);
+        return vsg::ubvec3Array2D::create(width, height, pixels, properties);
+    }
+    else
+    {
+        auto pixels = static_cast<vsg::ubvec4*>(vsg::allocate(numPixels * sizeof(vsg::ubvec4), vsg::ALLOCATOR_AFFINITY_DATA));
+        encodeLinear(scaled.data(), numPixels, srgb, reinterpret_cast<uint8_t*>(pixels), 4);
+        return vsg::ubvec4Array2D::create(width, height, pixels, properties);
+    }
+}
@@ -0,0 +1,106 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "gltf.h"
+
+#include <vsg/io/read.h>
+
+#include <filesystem>
+
+using namespace vsgXchange;
+
+const std::string gltf::ResourceCache::key("gltf::ResourceCache");
+
+gltf::ResourceCache::ResourceCache(size_t in_maxMemory) :
+    maxMemory(in_maxMemory)
+{
+}
+
+vsg::ref_ptr<vsg::Data> gltf::ResourceCache::read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const
+{
+    auto resolved = vsg::findFile(filename, options);
+    if (!resolved) return vsg::read_cast<vsg::Data>(filename, options);
+
+    std::error_code ec;
+    auto modified = std::filesystem::last_write_time(std::filesystem::path(resolved.string()), ec);
+    if (ec) return vsg::read_cast<vsg::Data>(resolved, options);
+
+    auto entryKey = resolved.string() + '|' + std::to_string(modified.time_since_epoch().count());
+
+    std::unique_lock<std::mutex> lock(_mutex);
+
+    if (auto itr = _entries.find(entryKey); itr != _entries.end())
+    {
+        if (!itr->second.ready)
+        {
+            ++_stats.coalesced;
+            _ready.wait(lock, [&]() { itr = _entries.find(entryKey); return itr == _entries.end() || itr->second.ready; });
+
+            // evicted, or the read failed so wasn't cached, before this thread woke so read it again
+            if (itr == _entries.end())
+            {
+                lock.unlock();
+                return vsg::read_cast<vsg::Data>(resolved, options);
+            }
+        }
+        else
+        {
+            ++_stats.hits;
+            _lru.splice(_lru.begin(), _lru, itr->second.lru);
+        }
+
+        return itr->second.data;
+    }
+
+    // mark the read as in flight so concurrent reads of the same file wait for it rather than reading it themselves
+    ++_stats.misses;
+    _entries[entryKey];
+
+    lock.unlock();
+    auto data = vsg::read_cast<vsg::Data>(resolved, options);
+    lock.lock();
+
+    if (!data)
+    {
+        // don't cache failures, so the file is read again once it's fixed and waiting reads retry it themselves
+        _entries.erase(entryKey);
+        _ready.notify_all();
+        return data;
+    }
+
+    auto& entry = _entries[entryKey];
+    entry.data = data;
+    entry.size = data->dataSize();
+    entry.ready = true;
+    entry.lru = _lru.insert(_lru.begin(), entryKey);
+    _stats.memory += entry.size;
+
+    // evict the least recently used entries, including this one if it alone exceeds the budget
+    while (_stats.memory > maxMemory && !_lru.empty())
+    {
+        auto evicted = _entries.find(_lru.back());
+        _stats.memory -= evicted->second.size;
+        ++_stats.evictions;
+        _entries.erase(evicted);
+        _lru.pop_back();
+    }
+
+    _ready.notify_all();
+
+    return data;
+}
+
+gltf::ResourceCache::Stats gltf::ResourceCache::stats() const
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+    return _stats;
+}
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #include <vsg/nodes/Group.h>
 #include <vsg/nodes/MatrixTransform.h>
+#include <vsg/nodes/VertexDraw.h>
 #include <vsg/nodes/VertexIndexDraw.h>
 #include <vsg/nodes/StateGroup.h>
 #include <vsg/nodes/DepthSorted.h>
@@ -35,9 +36,74 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vsg/utils/GraphicsPipelineConfigurator.h>
 #include <vsg/utils/ComputeBounds.h>
 #include <vsg/state/material.h>
+#include <vsg/state/DescriptorImage.h>
+#include <vsg/state/DescriptorSet.h>
+
+#include <algorithm>
+#include <cstring>
+#include <queue>
+#include <set>
+#include <tuple>
+#include <typeinfo>
 
 using namespace vsgXchange;
 
+namespace
+{
+    // returns true when the arrays are views interleaved within the same storage, assigning the offset of each array within the vertex, the stride and the first vertex
+    bool sourceInterleaving(const vsg::DataList& arrays, std::vector<uint32_t>& offsets, uint32_t& stride, const uint8_t*& base)
+    {
+        if (arrays.empty() || !arrays.front() || !arrays.front()->storage()) return false;
+
+        auto storage = arrays.front()->storage();
+        stride = arrays.front()->properties.stride;
+        size_t count = arrays.front()->valueCount();
+
+        base = static_cast<const uint8_t*>(arrays.front()->dataPointer());
+        for(auto& data : arrays)
+        {
+            if (!data || data->storage() != storage || data->properties.stride != stride || data->valueCount() != count) return false;
+            base = std::min(base, static_cast<const uint8_t*>(data->dataPointer()));
+        }
+
+        offsets.clear();
+        for(auto& data : arrays)
+        {
+            size_t offset = static_cast<const uint8_t*>(data->dataPointer()) - base;
+            if (offset + data->valueSize() > stride) return false;
+            offsets.push_back(static_cast<uint32_t>(offset));
+        }
+
+        // the whole of the last vertex must lie within the storage for the view to be uploaded
+        auto end = static_cast<const uint8_t*>(storage->dataPointer()) + storage->dataSize();
+        return base + count * stride <= end;
+    }
+
+    // collect the immediate children of a node, passed to node.traverse(..)
+    struct Children : public vsg::Visitor
+    {
+        std::vector<vsg::Node*> nodes;
+        void apply(vsg::Node& node) override { nodes.push_back(&node); }
+    };
+
+    // count the parents of each node in the subgraph, with the root of the subgraph counted as one
+    void countReferences(vsg::Node& node, std::map<const vsg::Node*, uint32_t>& references)
+    {
+        if (references[&node]++ > 0) return;
+
+        Children children;
+        node.traverse(children);
+        for(auto child : children.nodes) countReferences(*child, references);
+    }
+
+    // the index of the image sampled by the texture, or glTFid::invalid_value
+    uint32_t textureImage(const gltf::glTF& root, const gltf::glTFid& texture)
+    {
+        if (!texture || texture.value >= root.textures.values.size() || !root.textures.values[texture.value]) return gltf::glTFid::invalid_value;
+        return root.textures.values[texture.value]->source.value;
+    }
+}
+
 gltf::SceneGraphBuilder::SceneGraphBuilder()
 {
     attributeLookup = {
@@ -50,7 +116,11 @@ gltf::SceneGraphBuilder::SceneGraphBuilder()
 
 void gltf::SceneGraphBuilder::assign_extras(ExtensionsExtras& src, vsg::Object& dest)
 {
-    if (src.extras)
+    if (src.lazyExtras)
+    {
+        dest.setObject("extras", src.lazyExtras);
+    }
+    else if (src.extras)
     {
         if (src.extras->object)
         {
@@ -70,16 +140,20 @@ void gltf::SceneGraphBuilder::assign_name_extras(NameExtensionsExtras& src, vsg:
         dest.setValue("name", src.name);
     }
 
-    if (src.extras)
+    if (src.lazyExtras)
+    {
+        dest.setObject("extras", src.lazyExtras);
+    }
+    else if (src.extras)
     {
         if (src.extras->object)
         {
-            vsg::info("Assignig extras object ", src.extras->object);
+            vsg::debug("Assigning extras object ", src.extras->object);
             dest.setObject("extras", src.extras->object);
         }
         else if (src.extras->objects)
         {
-            vsg::info("Assignig extras objects ", src.extras->object);
+            vsg::debug("Assigning extras objects ", src.extras->objects);
             dest.setObject("extras", src.extras->objects);
         }
     }
@@ -92,91 +166,139 @@ vsg::ref_ptr<vsg::Data> gltf::SceneGraphBuilder::createBuffer(vsg::ref_ptr<gltf:
 
 vsg::ref_ptr<vsg::Data> gltf::SceneGraphBuilder::createBufferView(vsg::ref_ptr<gltf::BufferView> gltf_bufferView)
 {
-    if (!gltf_bufferView->buffer)
+    return createBufferView(gltf_bufferView->buffer, gltf_bufferView->byteOffset, gltf_bufferView->byteLength, gltf_bufferView->byteStride);
+}
+
+vsg::ref_ptr<vsg::Data> gltf::SceneGraphBuilder::createBufferView(glTFid buffer, uint32_t byteOffset, uint32_t byteLength, uint32_t byteStride)
+{
+    if (!buffer)
     {
         vsg::info("Warning: no buffer available to create BufferView.");
         return {};
     }
 
-    if (!vsg_buffers[gltf_bufferView->buffer.value])
+    if (!vsg_buffers[buffer.value])
     {
         vsg::info("Warning: no vsg::Data available to create BufferView.");
         return {};
     }
 
+    // a byteStride of 0 denotes tightly packed data
+    if (byteStride == 0) byteStride = 1;
+
     // TODO: deciode whether we need to do anything with the BufferView.target
-    auto vsg_buffer =  vsg::ubyteArray::create(vsg_buffers[gltf_bufferView->buffer.value],
-                                                gltf_bufferView->byteOffset,
-                                                gltf_bufferView->byteStride,
-                                                gltf_bufferView->byteLength / gltf_bufferView->byteStride);
+    auto vsg_buffer =  vsg::ubyteArray::create(vsg_buffers[buffer.value],
+                                                byteOffset,
+                                                byteStride,
+                                                byteLength / byteStride);
     return vsg_buffer;
 }
 
+void gltf::SceneGraphBuilder::createBufferViews(const CompactDocument& compact)
+{
+    auto& bufferViews = compact.bufferViews;
+    vsg_bufferViews.resize(bufferViews.size());
+    for(size_t bvi = 0; bvi<bufferViews.size(); ++bvi)
+    {
+        vsg_bufferViews[bvi] = createBufferView(bufferViews.buffer[bvi], bufferViews.byteOffset[bvi], bufferViews.byteLength[bvi], bufferViews.byteStride[bvi]);
+    }
+}
+
 vsg::ref_ptr<vsg::Data> gltf::SceneGraphBuilder::createAccessor(vsg::ref_ptr<gltf::Accessor> gltf_accessor)
 {
-    if (!gltf_accessor->bufferView)
+    return createAccessor(gltf_accessor->bufferView, gltf_accessor->byteOffset, gltf_accessor->componentType, gltf_accessor->type, gltf_accessor->count);
+}
+
+void gltf::SceneGraphBuilder::createAccessors(const CompactDocument& compact)
+{
+    auto& accessors = compact.accessors;
+    vsg_accessors.resize(accessors.size());
+    for(size_t ai = 0; ai<accessors.size(); ++ai)
+    {
+        vsg_accessors[ai] = createAccessor(accessors.bufferView[ai], accessors.byteOffset[ai], accessors.componentType[ai], compact.string(accessors.type[ai]), accessors.count[ai]);
+    }
+}
+
+vsg::ref_ptr<vsg::Data> gltf::SceneGraphBuilder::createAccessor(glTFid bufferViewID, uint32_t byteOffset, uint32_t componentType, const std::string_view& type, uint32_t count)
+{
+    if (!bufferViewID)
     {
         vsg::info("Warning: no bufferView available to create Accessor.");
         return {};
     }
 
-    if (!vsg_bufferViews[gltf_accessor->bufferView.value])
+    if (!vsg_bufferViews[bufferViewID.value])
     {
         vsg::info("Warning: no vsg::Data available to create BufferView.");
         return {};
     }
 
-    auto bufferView = vsg_bufferViews[gltf_accessor->bufferView.value];
+    auto bufferView = vsg_bufferViews[bufferViewID.value];
+
+    // interleaved vertex attributes step by the BufferView's byteStride rather than their element size
+    uint32_t byteStride = bufferView->properties.stride;
+    auto stride = [byteStride](uint32_t elementSize) { return std::max(elementSize, byteStride); };
 
     vsg::ref_ptr<vsg::Data> vsg_data;
-    switch(gltf_accessor->componentType)
+    switch(componentType)
     {
         case(5120): // BYTE
-            if      (gltf_accessor->type=="SCALAR") vsg_data = vsg::byteArray::create(bufferView, gltf_accessor->byteOffset, 1, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC2")   vsg_data = vsg::bvec2Array::create(bufferView, gltf_accessor->byteOffset, 2, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC3")   vsg_data = vsg::bvec3Array::create(bufferView, gltf_accessor->byteOffset, 3, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC4")   vsg_data = vsg::bvec4Array::create(bufferView, gltf_accessor->byteOffset, 4, gltf_accessor->count);
-            else vsg::warn("Unsupported gltf_accessor->componentType = ", gltf_accessor->componentType);
+            if      (type=="SCALAR") vsg_data = vsg::byteArray::create(bufferView, byteOffset, stride(1), count);
+            else if (type=="VEC2")   vsg_data = vsg::bvec2Array::create(bufferView, byteOffset, stride(2), count);
+            else if (type=="VEC3")   vsg_data = vsg::bvec3Array::create(bufferView, byteOffset, stride(3), count);
+            else if (type=="VEC4")   vsg_data = vsg::bvec4Array::create(bufferView, byteOffset, stride(4), count);
+            else vsg::warn("Unsupported componentType = ", componentType);
             break;
         case(5121): // UNSIGNED_BYTE
-            if      (gltf_accessor->type=="SCALAR") vsg_data = vsg::ubyteArray::create(bufferView, gltf_accessor->byteOffset, 1, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC2")   vsg_data = vsg::ubvec2Array::create(bufferView, gltf_accessor->byteOffset, 2, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC3")   vsg_data = vsg::ubvec3Array::create(bufferView, gltf_accessor->byteOffset, 3, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC4")   vsg_data = vsg::ubvec4Array::create(bufferView, gltf_accessor->byteOffset, 4, gltf_accessor->count);
-            else vsg::warn("Unsupported gltf_accessor->componentType = ", gltf_accessor->componentType);
+            if      (type=="SCALAR") vsg_data = vsg::ubyteArray::create(bufferView, byteOffset, stride(1), count);
+            else if (type=="VEC2")   vsg_data = vsg::ubvec2Array::create(bufferView, byteOffset, stride(2), count);
+            else if (type=="VEC3")   vsg_data = vsg::ubvec3Array::create(bufferView, byteOffset, stride(3), count);
+            else if (type=="VEC4")   vsg_data = vsg::ubvec4Array::create(bufferView, byteOffset, stride(4), count);
+            else vsg::warn("Unsupported componentType = ", componentType);
             break;
         case(5122): // SHORT
-            if      (gltf_accessor->type=="SCALAR") vsg_data = vsg::shortArray::create(bufferView, gltf_accessor->byteOffset, 2, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC2")   vsg_data = vsg::svec2Array::create(bufferView, gltf_accessor->byteOffset, 3, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC3")   vsg_data = vsg::svec3Array::create(bufferView, gltf_accessor->byteOffset, 6, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC4")   vsg_data = vsg::svec4Array::create(bufferView, gltf_accessor->byteOffset, 8, gltf_accessor->count);
-            else vsg::warn("Unsupported gltf_accessor->componentType = ", gltf_accessor->componentType);
+            if      (type=="SCALAR") vsg_data = vsg::shortArray::create(bufferView, byteOffset, stride(2), count);
+            else if (type=="VEC2")   vsg_data = vsg::svec2Array::create(bufferView, byteOffset, stride(4), count);
+            else if (type=="VEC3")   vsg_data = vsg::svec3Array::create(bufferView, byteOffset, stride(6), count);
+            else if (type=="VEC4")   vsg_data = vsg::svec4Array::create(bufferView, byteOffset, stride(8), count);
+            else vsg::warn("Unsupported componentType = ", componentType);
             break;
         case(5123): // UNSIGNED_SHORT
-            if      (gltf_accessor->type=="SCALAR") vsg_data = vsg::ushortArray::create(bufferView, gltf_accessor->byteOffset, 2, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC2")   vsg_data = vsg::usvec2Array::create(bufferView, gltf_accessor->byteOffset, 4, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC3")   vsg_data = vsg::usvec3Array::create(bufferView, gltf_accessor->byteOffset, 6, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC4")   vsg_data = vsg::usvec4Array::create(bufferView, gltf_accessor->byteOffset, 8, gltf_accessor->count);
-            else vsg::warn("Unsupported gltf_accessor->componentType = ", gltf_accessor->componentType);
+            if      (type=="SCALAR") vsg_data = vsg::ushortArray::create(bufferView, byteOffset, stride(2), count);
+            else if (type=="VEC2")   vsg_data = vsg::usvec2Array::create(bufferView, byteOffset, stride(4), count);
+            else if (type=="VEC3")   vsg_data = vsg::usvec3Array::create(bufferView, byteOffset, stride(6), count);
+            else if (type=="VEC4")   vsg_data = vsg::usvec4Array::create(bufferView, byteOffset, stride(8), count);
+            else vsg::warn("Unsupported componentType = ", componentType);
             break;
         case(5125): // UNSIGNED_INT
-            if      (gltf_accessor->type=="SCALAR") vsg_data = vsg::uintArray::create(bufferView, gltf_accessor->byteOffset, 4, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC2")   vsg_data = vsg::uivec2Array::create(bufferView, gltf_accessor->byteOffset, 8, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC3")   vsg_data = vsg::uivec3Array::create(bufferView, gltf_accessor->byteOffset, 12, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC4")   vsg_data = vsg::uivec4Array::create(bufferView, gltf_accessor->byteOffset, 16, gltf_accessor->count);
-            else vsg::warn("Unsupported gltf_accessor->componentType = ", gltf_accessor->componentType);
+            if      (type=="SCALAR") vsg_data = vsg::uintArray::create(bufferView, byteOffset, stride(4), count);
+            else if (type=="VEC2")   vsg_data = vsg::uivec2Array::create(bufferView, byteOffset, stride(8), count);
+            else if (type=="VEC3")   vsg_data = vsg::uivec3Array::create(bufferView, byteOffset, stride(12), count);
+            else if (type=="VEC4")   vsg_data = vsg::uivec4Array::create(bufferView, byteOffset, stride(16), count);
+            else vsg::warn("Unsupported componentType = ", componentType);
             break;
         case(5126): // FLOAT
-            if      (gltf_accessor->type=="SCALAR") vsg_data = vsg::byteArray::create(bufferView, gltf_accessor->byteOffset, 4, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC2")   vsg_data = vsg::vec2Array::create(bufferView, gltf_accessor->byteOffset, 8, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC3")   vsg_data = vsg::vec3Array::create(bufferView, gltf_accessor->byteOffset, 12, gltf_accessor->count);
-            else if (gltf_accessor->type=="VEC4")   vsg_data = vsg::vec4Array::create(bufferView, gltf_accessor->byteOffset, 16, gltf_accessor->count);
-            //else if (gltf_accessor->type=="MAT2")   vsg_data = vsg::mat2Array::create(bufferView, gltf_accessor->byteOffset, 16, gltf_accessor->count);
-            //else if (gltf_accessor->type=="MAT3")   vsg_data = vsg::mat3Array::create(bufferView, gltf_accessor->byteOffset, 36, gltf_accessor->count);
-            else if (gltf_accessor->type=="MAT4")   vsg_data = vsg::mat4Array::create(bufferView, gltf_accessor->byteOffset, 64, gltf_accessor->count);
-            else vsg::warn("Unsupported gltf_accessor->componentType = ", gltf_accessor->componentType);
+            if      (type=="SCALAR") vsg_data = vsg::floatArray::create(bufferView, byteOffset, stride(4), count);
+            else if (type=="VEC2")   vsg_data = vsg::vec2Array::create(bufferView, byteOffset, stride(8), count);
+            else if (type=="VEC3")   vsg_data = vsg::vec3Array::create(bufferView, byteOffset, stride(12), count);
+            else if (type=="VEC4")   vsg_data = vsg::vec4Array::create(bufferView, byteOffset, stride(16), count);
+            //else if (type=="MAT2")   vsg_data = vsg::mat2Array::create(bufferView, byteOffset, stride(16), count);
+            //else if (type=="MAT3")   vsg_data = vsg::mat3Array::create(bufferView, byteOffset, stride(36), count);
+            else if (type=="MAT4")   vsg_data = vsg::mat4Array::create(bufferView, byteOffset, stride(64), count);
+            else vsg::warn("Unsupported componentType = ", componentType);
             break;
     }
+
+    // copy interleaved attributes whose view would extend past the end of the BufferView
+    if (vsg_data && vsg_data->properties.stride > vsg_data->valueSize() && byteOffset + static_cast<size_t>(count) * vsg_data->properties.stride > bufferView->dataSize())
+    {
+        if (auto copy = createCompatibleArray(*vsg_data, count))
+        {
+            copyValues(*vsg_data, 0, *copy, 0, count);
+            vsg_data = copy;
+        }
+    }
+
 #if 0
     //if (vsg_data->storage())
     {
@@ -438,7 +560,7 @@ vsg::ref_ptr<vsg::DescriptorConfigurator> gltf::SceneGraphBuilder::createMateria
     // TODO: pbrMaterial.alphaMask = 1.0f;
     // TODO: material.alphaMode string?
 
-    if (auto materials_specular = gltf_material->extension<KHR_materials_specular>("KHR_materials_specular"))
+    if (auto materials_specular = gltf_material->extension<KHR_materials_specular>(KHR_materials_specular_id))
     {
         float sf = materials_specular->specularFactor;
         pbrMaterial.specularFactor.set(sf, sf, sf, 1.0);
@@ -471,16 +593,16 @@ vsg::ref_ptr<vsg::DescriptorConfigurator> gltf::SceneGraphBuilder::createMateria
     }
 
 #if 0
-    if (auto materials_ior = gltf_material->extension<KHR_materials_ior>("KHR_materials_ior"))
+    if (auto materials_ior = gltf_material->extension<KHR_materials_ior>(KHR_materials_ior_id))
     {
         vsg::info("Have Index Of Refraction: ", materials_ior);
     }
 
     if (gltf_material->extensions)
     {
-        for(auto& [name, schema] : gltf_material->extensions->values)
+        for(auto& extension : gltf_material->extensions->values)
         {
-            vsg::info("extensions ", name, ", ", schema);
+            vsg::info("extensions ", extension.name, ", ", extension.schema);
         }
     }
 #endif
@@ -539,10 +661,7 @@ vsg::ref_ptr<vsg::Node> gltf::SceneGraphBuilder::createMesh(vsg::ref_ptr<gltf::M
     for(auto& primitive : gltf_mesh->primitives.values)
     {
         auto vsg_material = vsg_materials[primitive->material.value];
-
-        auto config = vsg::GraphicsPipelineConfigurator::create(vsg_material->shaderSet);
-        config->descriptorConfigurator = vsg_material;
-        // TODO: if (options) config->assignInheritedState(options->inheritedState);
+        auto& shaderSet = vsg_material->shaderSet;
 
 #if 0
         vsg::info("    primitive = {");
@@ -564,11 +683,18 @@ vsg::ref_ptr<vsg::Node> gltf::SceneGraphBuilder::createMesh(vsg::ref_ptr<gltf::M
 #endif
 
 
-        auto vid = vsg::VertexIndexDraw::create();
+        vsg::DataList vertexArrays;
 
-        assign_extras(*primitive, *vid);
+        // the bindings are only assigned to a GraphicsPipelineConfigurator for the first primitive with each pipeline state, so are recorded
+        // here for the arrays the shaderSet has attributes for, as GraphicsPipelineConfigurator::assignArray(..) would
+        std::vector<VertexBinding> vertexBindings;
+        auto assignBinding = [&](const std::string& name, VkVertexInputRate vertexInputRate, vsg::ref_ptr<vsg::Data> data)
+        {
+            if (!shaderSet->getAttributeBinding(name)) return;
 
-        vsg::DataList vertexArrays;
+            vertexBindings.push_back(VertexBinding{name, vertexInputRate, data});
+            vertexArrays.push_back(data);
+        };
 
         auto assignArray = [&](const std::string& attribute_name) -> bool
         {
@@ -578,72 +704,250 @@ vsg::ref_ptr<vsg::Node> gltf::SceneGraphBuilder::createMesh(vsg::ref_ptr<gltf::M
             auto name_itr = attributeLookup.find(attribute_name);
             if (name_itr == attributeLookup.end()) return true;
 
-            config->assignArray(vertexArrays, name_itr->second, VK_VERTEX_INPUT_RATE_VERTEX, vsg_accessors[array_itr->second.value]);
+            assignBinding(name_itr->second, VK_VERTEX_INPUT_RATE_VERTEX, vsg_accessors[array_itr->second.value]);
             return true;
         };
 
-        assignArray("POSITION");
+        int positionArray = static_cast<int>(vertexArrays.size());
+        if (!assignArray("POSITION") || positionArray == static_cast<int>(vertexArrays.size())) positionArray = -1;
 
-        assignArray("NORMAL");
+        int normalArray = static_cast<int>(vertexArrays.size());
+        if (!assignArray("NORMAL") || normalArray == static_cast<int>(vertexArrays.size())) normalArray = -1;
 
         assignArray("TEXCOORD_0");
 
-        if (!assignArray("COLOR_0"))
+        bool hasColors = assignArray("COLOR_0");
+
+        size_t numVertexArrays = vertexArrays.size();
+
+        if (!hasColors)
         {
             auto defaultColor = vsg::vec4Value::create(1.0f, 1.0f, 1.0f, 1.0f);
-            config->assignArray(vertexArrays, "vsg_Color", VK_VERTEX_INPUT_RATE_INSTANCE, defaultColor);
+            assignBinding("vsg_Color", VK_VERTEX_INPUT_RATE_INSTANCE, defaultColor);
+        }
+
+        InterleavableDraw interleavable;
+        if (interleaveVertices && numVertexArrays > 1)
+        {
+            vsg::DataList perVertexArrays(vertexArrays.begin(), vertexArrays.begin() + numVertexArrays);
+
+            bool sameCount = true;
+            for(auto& data : perVertexArrays) sameCount = sameCount && data && data->valueCount() == perVertexArrays.front()->valueCount();
+
+            if (sameCount)
+            {
+                // the interleaved array is a view of the first array's type, which must start the vertex for the whole vertex to be uploaded
+                const uint8_t* base = nullptr;
+                if (!sourceInterleaving(perVertexArrays, interleavable.offsets, interleavable.stride, base) || interleavable.offsets.front() != 0)
+                {
+                    // pack the attributes in binding order with each aligned to 4 bytes
+                    interleavable.offsets.clear();
+                    interleavable.stride = 0;
+                    for(auto& data : perVertexArrays)
+                    {
+                        interleavable.offsets.push_back(interleavable.stride);
+                        interleavable.stride += (static_cast<uint32_t>(data->valueSize()) + 3) & ~3u;
+                    }
+                }
+            }
         }
 
-        vid->assignArrays(vertexArrays);
+        vsg::ref_ptr<vsg::Data> positions;
+        auto position_itr = primitive->attributes.values.find("POSITION");
+        if (position_itr != primitive->attributes.values.end()) positions = vsg_accessors[position_itr->second.value];
+
+        uint32_t numVertices = positions ? static_cast<uint32_t>(positions->valueCount()) : 0;
+
+        // primitives without vertices to weld are drawn with a VertexDraw rather than left with a VertexIndexDraw that has no indices
+        bool weldIndices = !primitive->indices && generateIndices && VertexWelder::weldable(vertexArrays, numVertices);
+
+        vsg::ref_ptr<vsg::Command> draw;
+        vsg::ref_ptr<vsg::VertexIndexDraw> vid;
+        if (primitive->indices || weldIndices)
+        {
+            vid = vsg::VertexIndexDraw::create();
+            vid->assignArrays(vertexArrays);
+
+            if (primitive->indices)
+            {
+                auto indices = vsg_accessors[primitive->indices.value];
+                vid->assignIndices(indices);
+                vid->indexCount = static_cast<uint32_t>(indices->valueCount());
+            }
+            else
+            {
+                // indices assigned by weldVertices()
+                weldableDraws.push_back(WeldableDraw{vid, vertexArrays, numVertices});
+            }
+
+            vid->instanceCount = 1;
 
-        if (primitive->indices)
+            draw = vid;
+        }
+        else
         {
-            auto indices = vsg_accessors[primitive->indices.value];
-            vid->assignIndices(indices);
-            vid->indexCount = static_cast<uint32_t>(indices->valueCount());
-        } // TODO: else use VertexDraw?
+            auto vd = vsg::VertexDraw::create();
+            vd->assignArrays(vertexArrays);
+            vd->vertexCount = numVertices;
+            vd->instanceCount = 1;
+
+            draw = vd;
+        }
 
+        assign_extras(*primitive, *draw);
 
-        vid->instanceCount = 1;
+        if ((flattenStaticTransforms || batchStaticGeometry) && !vsg_material->blending && (primitive->mode == 0 || primitive->mode == 1 || primitive->mode == 4) && positionArray >= 0)
+        {
+            staticPrimitives[draw.get()] = GeometryBatcher::Primitive{draw, vsg::dmat4(), positionArray, normalArray, primitive->mode == 4};
+        }
 
-        // set the GraphicsPipelineStates to the required values.
-        struct SetPipelineStates : public vsg::Visitor
+        if (interleavable.stride > 0)
         {
-            VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-            bool blending = false;
-            bool two_sided = false;
+            // the arrays themselves are interleaved by interleaveVertexArrays() once welding and optimization have finished with them
+            interleavable.draw = draw;
+            interleavableDraws.push_back(interleavable);
+        }
 
-            SetPipelineStates(VkPrimitiveTopology in_topology, bool in_blending, bool in_two_sided) :
-                topology(in_topology), blending(in_blending), two_sided(in_two_sided) {}
+        if (optimizeGeometry && vid)
+        {
+            for(auto& bufferInfo : vid->arrays)
+            {
+                if (bufferInfo) ++vertexArrayUsage[bufferInfo->data.get()];
+            }
 
-            void apply(vsg::Object& object) { object.traverse(*this); }
-            void apply(vsg::RasterizationState& rs)
+            if (primitive->mode == 4)
             {
-                if (two_sided) rs.cullMode = VK_CULL_MODE_NONE;
+                optimizableTriangles.push_back(OptimizableTriangles{vid, positions.cast<vsg::vec3Array>()});
             }
-            void apply(vsg::InputAssemblyState& ias) { ias.topology = topology; }
-            void apply(vsg::ColorBlendState& cbs) { cbs.configureAttachments(blending); }
+        }
 
-        } sps(topologyLookup[primitive->mode], vsg_material->blending, vsg_material->two_sided);
+        // primitives with the same material, vertex bindings, topology and interleaving share the state created for the first of them
+        std::string pipelineKey;
+        auto append = [&pipelineKey](const void* ptr, size_t size) { pipelineKey.append(static_cast<const char*>(ptr), size); };
 
-        config->accept(sps);
+        auto materialPtr = vsg_material.get();
+        append(&materialPtr, sizeof(materialPtr));
+        append(&primitive->mode, sizeof(primitive->mode));
+        for(auto& binding : vertexBindings)
+        {
+            pipelineKey.append(binding.name);
+            pipelineKey.push_back('\0');
+            append(&binding.vertexInputRate, sizeof(binding.vertexInputRate));
+            append(&binding.data->properties.format, sizeof(binding.data->properties.format));
+            append(&binding.data->properties.stride, sizeof(binding.data->properties.stride));
+        }
+        for(auto offset : interleavable.offsets) append(&offset, sizeof(offset));
+        append(&interleavable.stride, sizeof(interleavable.stride));
 
-        if (sharedObjects)
-            sharedObjects->share(config, [](auto gpc) { gpc->init(); });
-        else
-            config->init();
+        auto& pipelineState = pipelineStates[pipelineKey];
+        if (!pipelineState)
+        {
+            auto config = vsg::GraphicsPipelineConfigurator::create(shaderSet);
+            config->descriptorConfigurator = vsg_material;
+            // TODO: if (options) config->assignInheritedState(options->inheritedState);
+
+            vsg::DataList configArrays;
+            for(auto& binding : vertexBindings)
+            {
+                config->assignArray(configArrays, binding.name, binding.vertexInputRate, binding.data);
+            }
+
+            if (interleavable.stride > 0)
+            {
+                // replace the per vertex bindings with one binding, moving the bindings after them down to follow it
+                struct InterleaveBindings : public vsg::Visitor
+                {
+                    const InterleavableDraw& interleavable;
+                    uint32_t firstBinding = 0;
+                    uint32_t numBindings = 0;
+
+                    InterleaveBindings(const InterleavableDraw& in_interleavable, uint32_t in_firstBinding, uint32_t in_numBindings) :
+                        interleavable(in_interleavable), firstBinding(in_firstBinding), numBindings(in_numBindings) {}
+
+                    void apply(vsg::Object& object) { object.traverse(*this); }
+                    void apply(vsg::VertexInputState& vis)
+                    {
+                        auto interleaved = [&](uint32_t binding) { return binding >= firstBinding && binding < firstBinding + numBindings; };
+
+                        for(auto& attribute : vis.vertexAttributeDescriptions)
+                        {
+                            if (interleaved(attribute.binding))
+                            {
+                                attribute.offset = interleavable.offsets[attribute.binding - firstBinding];
+                                attribute.binding = firstBinding;
+                            }
+                            else if (attribute.binding > firstBinding)
+                            {
+                                attribute.binding -= numBindings - 1;
+                            }
+                        }
+
+                        std::vector<VkVertexInputBindingDescription> bindings;
+                        bindings.push_back(VkVertexInputBindingDescription{firstBinding, interleavable.stride, VK_VERTEX_INPUT_RATE_VERTEX});
+                        for(auto& binding : vis.vertexBindingDescriptions)
+                        {
+                            if (interleaved(binding.binding)) continue;
+                            if (binding.binding > firstBinding) binding.binding -= numBindings - 1;
+                            bindings.push_back(binding);
+                        }
+                        vis.vertexBindingDescriptions = bindings;
+                    }
+                } interleaveBindings(interleavable, config->baseAttributeBinding, static_cast<uint32_t>(numVertexArrays));
+
+                config->accept(interleaveBindings);
+            }
+
+            // set the GraphicsPipelineStates to the required values.
+            struct SetPipelineStates : public vsg::Visitor
+            {
+                VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+                bool blending = false;
+                bool two_sided = false;
+
+                SetPipelineStates(VkPrimitiveTopology in_topology, bool in_blending, bool in_two_sided) :
+                    topology(in_topology), blending(in_blending), two_sided(in_two_sided) {}
+
+                void apply(vsg::Object& object) { object.traverse(*this); }
+                void apply(vsg::RasterizationState& rs)
+                {
+                    if (two_sided) rs.cullMode = VK_CULL_MODE_NONE;
+                }
+                void apply(vsg::InputAssemblyState& ias) { ias.topology = topology; }
+                void apply(vsg::ColorBlendState& cbs) { cbs.configureAttachments(blending); }
+
+            } sps(topologyLookup[primitive->mode], vsg_material->blending, vsg_material->two_sided);
+
+            config->accept(sps);
+
+            if (sharedObjects)
+                sharedObjects->share(config, [](auto gpc) { gpc->init(); });
+            else
+                config->init();
+
+            pipelineState = vsg::StateGroup::create();
+            config->copyTo(pipelineState, sharedObjects);
+        }
 
         // create StateGroup as the root of the scene/command graph to hold the GraphicsPipeline, and binding of Descriptors to decorate the whole graph
         auto stateGroup = vsg::StateGroup::create();
+        stateGroup->stateCommands = pipelineState->stateCommands;
+        stateGroup->prototypeArrayState = pipelineState->prototypeArrayState;
 
-        config->copyTo(stateGroup, sharedObjects);
+        stateGroup->addChild(draw);
 
-        stateGroup->addChild(vid);
+        if (buildClusters && vid && primitive->mode == 4)
+        {
+            if (auto vec3Positions = positions.cast<vsg::vec3Array>())
+            {
+                clusterableTriangles.push_back(ClusterableTriangles{stateGroup, vid, vec3Positions, !vsg_material->two_sided});
+            }
+        }
 
         if (vsg_material->blending)
         {
             vsg::ComputeBounds computeBounds;
-            vid->accept(computeBounds);
+            if (vid && !vid->indices && positions) positions->accept(computeBounds); // indices still to be generated by weldVertices()
+            else draw->accept(computeBounds);
             vsg::dvec3 center = (computeBounds.bounds.min + computeBounds.bounds.max) * 0.5;
             double radius = vsg::length(computeBounds.bounds.max - computeBounds.bounds.min) * 0.5;
 
@@ -693,49 +997,44 @@ vsg::ref_ptr<vsg::Node> gltf::SceneGraphBuilder::createMesh(vsg::ref_ptr<gltf::M
 
 vsg::ref_ptr<vsg::Node> gltf::SceneGraphBuilder::createNode(vsg::ref_ptr<gltf::Node> gltf_node)
 {
-    vsg::ref_ptr<vsg::Node> vsg_node;
-
     bool isTransform = !(gltf_node->matrix.values.empty()) ||
                         !(gltf_node->rotation.values.empty()) ||
                         !(gltf_node->scale.values.empty()) ||
                         !(gltf_node->translation.values.empty());
 
-    size_t numChildren = gltf_node->children.values.size();
-    if (gltf_node->camera) ++numChildren;
-    if (gltf_node->skin) ++numChildren;
-    if (gltf_node->mesh) ++numChildren;
-
+    vsg::dmat4 matrix;
     if (isTransform)
     {
-        auto transform = vsg::MatrixTransform::create();
-        if (gltf_node->camera) transform->addChild(vsg_cameras[gltf_node->camera.value]);
-        else if (gltf_node->skin) transform->addChild(vsg_skins[gltf_node->skin.value]);
-        else if (gltf_node->mesh) transform->addChild(vsg_meshes[gltf_node->mesh.value]);
+        auto& m = gltf_node->matrix.values;
+        auto& t = gltf_node->translation.values;
+        auto& r = gltf_node->rotation.values;
+        auto& s = gltf_node->scale.values;
+        matrix = nodeMatrix(m.data(), m.size(), t.data(), t.size(), r.data(), r.size(), s.data(), s.size());
+    }
 
-        if (gltf_node->matrix.values.size()==16)
-        {
-            auto& m = gltf_node->matrix.values;
-            transform->matrix.set(m[0], m[1], m[2], m[3],
-                                  m[4], m[5], m[6], m[7],
-                                  m[8], m[9], m[10], m[11],
-                                  m[12], m[13], m[14], m[15]);
-        }
-        else
-        {
-            auto& t = gltf_node->translation.values;
-            auto& r = gltf_node->rotation.values;
-            auto& s = gltf_node->scale.values;
+    auto vsg_node = createNode(gltf_node->camera, gltf_node->skin, gltf_node->mesh, gltf_node->children.values.size(), isTransform ? &matrix : nullptr);
 
-            vsg::dvec3 vsg_t(0.0, 0.0, 0.0);
-            vsg::dquat vsg_r;
-            vsg::dvec3 vsg_s(1.0, 1.0, 1.0);
+    assign_name_extras(*gltf_node, *vsg_node);
 
-            if (t.size()>=3) vsg_t.set(t[0], t[1], t[2]);
-            if (r.size()>=4) vsg_r.set(r[0], r[1], r[2], r[3]);
-            if (s.size()>=3) vsg_s.set(s[0], s[1], s[2]);
+    return vsg_node;
+}
 
-            transform->matrix = vsg::translate(vsg_t) * vsg::rotate(vsg_r) * vsg::scale(vsg_s);
-        }
+vsg::ref_ptr<vsg::Node> gltf::SceneGraphBuilder::createNode(glTFid camera, glTFid skin, glTFid mesh, size_t numChildren, const vsg::dmat4* matrix)
+{
+    vsg::ref_ptr<vsg::Node> vsg_node;
+
+    if (camera) ++numChildren;
+    if (skin) ++numChildren;
+    if (mesh) ++numChildren;
+
+    if (matrix)
+    {
+        auto transform = vsg::MatrixTransform::create();
+        if (camera) transform->addChild(vsg_cameras[camera.value]);
+        else if (skin) transform->addChild(vsg_skins[skin.value]);
+        else if (mesh) transform->addChild(vsg_meshes[mesh.value]);
+
+        transform->matrix = *matrix;
 
         vsg_node = transform;
     }
@@ -743,25 +1042,75 @@ vsg::ref_ptr<vsg::Node> gltf::SceneGraphBuilder::createNode(vsg::ref_ptr<gltf::N
     {
         auto group = vsg::Group::create();
 
-        if (gltf_node->camera) group->addChild(vsg_cameras[gltf_node->camera.value]);
-        else if (gltf_node->skin) group->addChild(vsg_skins[gltf_node->skin.value]);
-        else if (gltf_node->mesh) group->addChild(vsg_meshes[gltf_node->mesh.value]);
+        if (camera) group->addChild(vsg_cameras[camera.value]);
+        else if (skin) group->addChild(vsg_skins[skin.value]);
+        else if (mesh) group->addChild(vsg_meshes[mesh.value]);
 
         vsg_node = group;
     }
     else
     {
-        if (gltf_node->camera) vsg_node = vsg_cameras[gltf_node->camera.value];
-        else if (gltf_node->skin) vsg_node = vsg_skins[gltf_node->skin.value];
-        else if (gltf_node->mesh) vsg_node = vsg_meshes[gltf_node->mesh.value];
+        if (camera) vsg_node = vsg_cameras[camera.value];
+        else if (skin) vsg_node = vsg_skins[skin.value];
+        else if (mesh) vsg_node = vsg_meshes[mesh.value];
         else vsg_node = vsg::Group::create(); // TODO: single child so should this just point to the child?
     }
 
-    assign_name_extras(*gltf_node, *vsg_node);
-
     return vsg_node;
 }
 
+void gltf::SceneGraphBuilder::createNodes(const CompactDocument& compact)
+{
+    auto& nodes = compact.nodes;
+
+    vsg_nodes.resize(nodes.size());
+    for(size_t ni=0; ni<nodes.size(); ++ni)
+    {
+        auto& m = nodes.matrix[ni];
+        auto& t = nodes.translation[ni];
+        auto& r = nodes.rotation[ni];
+        auto& s = nodes.scale[ni];
+
+        bool isTransform = m.count > 0 || r.count > 0 || s.count > 0 || t.count > 0;
+
+        vsg::dmat4 matrix;
+        if (isTransform)
+        {
+            matrix = nodeMatrix(compact.values(m), m.count, compact.values(t), t.count, compact.values(r), r.count, compact.values(s), s.count);
+        }
+
+        auto vsg_node = createNode(nodes.camera[ni], nodes.skin[ni], nodes.mesh[ni], nodes.children[ni].count, isTransform ? &matrix : nullptr);
+
+        if (auto name = compact.string(nodes.name[ni]); !name.empty())
+        {
+            vsg_node->setValue("name", std::string(name));
+        }
+
+        if (nodes.extensionsExtras[ni] != CompactDocument::invalid_id)
+        {
+            assign_extras(*compact.extensionsExtras[nodes.extensionsExtras[ni]], *vsg_node);
+        }
+
+        vsg_nodes[ni] = vsg_node;
+    }
+
+    for(size_t ni=0; ni<nodes.size(); ++ni)
+    {
+        auto numChildren = nodes.children[ni].count;
+        if (numChildren > 0)
+        {
+            auto vsg_group = vsg_nodes[ni].cast<vsg::Group>();
+            auto children = compact.children(static_cast<uint32_t>(ni));
+            for(uint32_t ci = 0; ci < numChildren; ++ci)
+            {
+                auto vsg_child = vsg_nodes[children[ci].value];
+                if (vsg_child) vsg_group->addChild(vsg_child);
+                else vsg::info("Unassigned vsg_child");
+            }
+        }
+    }
+}
+
 vsg::ref_ptr<vsg::Node> gltf::SceneGraphBuilder::createScene(vsg::ref_ptr<gltf::Scene> gltf_scene)
 {
     if (gltf_scene->nodes.values.empty())
@@ -824,28 +1173,65 @@ vsg::ref_ptr<vsg::Object> gltf::SceneGraphBuilder::createSceneGraph(vsg::ref_ptr
     if (options) sharedObjects = options->sharedObjects;
     if (!sharedObjects) sharedObjects = vsg::SharedObjects::create();
 
+    // resolve the ids of the extensions queried per material once rather than comparing names for every material
+    if (root->extensionRegistry)
+    {
+        KHR_materials_specular_id = root->extensionRegistry->id("KHR_materials_specular");
+        KHR_materials_ior_id = root->extensionRegistry->id("KHR_materials_ior");
+    }
+
     if (!shaderSet)
     {
         shaderSet = vsg::createPhysicsBasedRenderingShaderSet(options);
         if (sharedObjects) sharedObjects->share(shaderSet);
     }
 
+    bool report = vsg::value<bool>(false, gltf::report, options);
+    optimizeGeometry = vsg::value<bool>(false, gltf::optimize_geometry, options);
+    generateIndices = vsg::value<bool>(false, gltf::generate_indices, options);
+    interleaveVertices = vsg::value<bool>(false, gltf::interleave_vertices, options);
+    flattenStaticTransforms = vsg::value<bool>(false, gltf::flatten_transforms, options);
+    batchStaticGeometry = vsg::value<bool>(false, gltf::batch_geometry, options);
+    buildClusters = vsg::value<bool>(false, gltf::meshlets, options);
+    clusterBuilder.maxVertices = vsg::value<uint32_t>(clusterBuilder.maxVertices, gltf::meshlet_vertices, options);
+    clusterBuilder.maxTriangles = vsg::value<uint32_t>(clusterBuilder.maxTriangles, gltf::meshlet_triangles, options);
+    imagePreparer.filter = (vsg::value<std::string>("box", gltf::mipmap_filter, options) == "kaiser") ? ImagePreparer::KAISER : ImagePreparer::BOX;
+    auto compressionQuality = vsg::value<std::string>("normal", gltf::compression_quality, options);
+    blockCompressor.quality = compressionQuality == "fast" ? BlockCompressor::FAST : (compressionQuality == "high" ? BlockCompressor::HIGH : BlockCompressor::NORMAL);
+    blockCompressor.bc5Normals = vsg::value<bool>(false, gltf::bc5_normals, options);
+    if (options) blockCompressor.cacheDirectory = options->fileCache;
+
+    // images and buffers are shared by content, samplers and materials by value, with the images shared before the materials that use them
+    vsg::ref_ptr<ContentRegistry> contentRegistry;
+    if (vsg::value<bool>(false, gltf::share_content, options)) contentRegistry = sharedObjects->shared_default<ContentRegistry>();
+    size_t numSharedBefore = contentRegistry ? contentRegistry->numShared.load() : 0;
+    size_t bytesSavedBefore = contentRegistry ? contentRegistry->bytesSaved.load() : 0;
+
     vsg_buffers.resize(root->buffers.values.size());
     for(size_t bi = 0; bi<root->buffers.values.size(); ++bi)
     {
         vsg_buffers[bi] = createBuffer(root->buffers.values[bi]);
+        if (contentRegistry) vsg_buffers[bi] = contentRegistry->share(vsg_buffers[bi]);
     }
 
-    vsg_bufferViews.resize(root->bufferViews.values.size());
-    for(size_t bvi = 0; bvi<root->bufferViews.values.size(); ++bvi)
+    if (root->compact)
     {
-        vsg_bufferViews[bvi] = createBufferView(root->bufferViews.values[bvi]);
+        createBufferViews(*root->compact);
+        createAccessors(*root->compact);
     }
-
-    vsg_accessors.resize(root->accessors.values.size());
-    for(size_t ai = 0; ai<root->accessors.values.size(); ++ai)
+    else
     {
-        vsg_accessors[ai] = createAccessor(root->accessors.values[ai]);
+        vsg_bufferViews.resize(root->bufferViews.values.size());
+        for(size_t bvi = 0; bvi<root->bufferViews.values.size(); ++bvi)
+        {
+            vsg_bufferViews[bvi] = createBufferView(root->bufferViews.values[bvi]);
+        }
+
+        vsg_accessors.resize(root->accessors.values.size());
+        for(size_t ai = 0; ai<root->accessors.values.size(); ++ai)
+        {
+            vsg_accessors[ai] = createAccessor(root->accessors.values[ai]);
+        }
     }
 
     // vsg::info("create cameras = ", root->cameras.values.size());
@@ -871,6 +1257,7 @@ vsg::ref_ptr<vsg::Object> gltf::SceneGraphBuilder::createSceneGraph(vsg::ref_ptr
     for(size_t sai=0; sai<root->samplers.values.size(); ++sai)
     {
         vsg_samplers[sai] = createSampler(root->samplers.values[sai]);
+        if (contentRegistry) sharedObjects->share(vsg_samplers[sai]);
     }
 
     // vsg::info("create images = ", root->images.values.size());
@@ -880,6 +1267,31 @@ vsg::ref_ptr<vsg::Object> gltf::SceneGraphBuilder::createSceneGraph(vsg::ref_ptr
          if (root->images.values[ii]) vsg_images[ii] = createImage(root->images.values[ii]);
     }
 
+    // block compressed formats can't have their mipmaps generated by blits when compiled, so compress_images implies prepare_images
+    bool blockCompress = vsg::value<bool>(false, gltf::compress_images, options);
+    bool generateMipmaps = blockCompress || vsg::value<bool>(false, gltf::prepare_images, options);
+    uint32_t maxTextureSize = vsg::value<uint32_t>(0, gltf::max_texture_size, options);
+    size_t textureBudget = static_cast<size_t>(vsg::value<uint32_t>(0, gltf::texture_budget, options)) * 1024 * 1024;
+    if (maxTextureSize > 0 || textureBudget > 0)
+    {
+        downscaleImages(*root, maxTextureSize, textureBudget, generateMipmaps, options ? options->operationThreads : vsg::ref_ptr<vsg::OperationThreads>(), report);
+    }
+
+    if (generateMipmaps)
+    {
+        prepareImages(options ? options->operationThreads : vsg::ref_ptr<vsg::OperationThreads>(), report);
+    }
+
+    if (blockCompress)
+    {
+        compressImages(*root, options, report);
+    }
+
+    if (contentRegistry)
+    {
+        for(auto& image : vsg_images) image = contentRegistry->share(image);
+    }
+
     // vsg::info("create textures = ", root->textures.values.size());
     vsg_textures.resize(root->textures.values.size());
     for(size_t ti=0; ti<root->textures.values.size(); ++ti)
@@ -892,34 +1304,77 @@ vsg::ref_ptr<vsg::Object> gltf::SceneGraphBuilder::createSceneGraph(vsg::ref_ptr
     for(size_t mi=0; mi<root->materials.values.size(); ++mi)
     {
         vsg_materials[mi] = createMaterial(root->materials.values[mi]);
+        if (contentRegistry) sharedObjects->share(vsg_materials[mi]);
+    }
+
+    if (contentRegistry && report)
+    {
+        vsg::info("gltf::SceneGraphBuilder::createSceneGraph() images and buffers shared = ", contentRegistry->numShared.load() - numSharedBefore,
+                  ", bytes saved = ", contentRegistry->bytesSaved.load() - bytesSavedBefore, ", over all loads = ", contentRegistry->bytesSaved.load());
     }
 
     // vsg::info("create meshes = ", root->meshes.values.size());
+    auto before_meshes = vsg::clock::now();
+    size_t numPrimitives = 0;
     vsg_meshes.resize(root->meshes.values.size());
     for(size_t mi=0; mi<root->meshes.values.size(); ++mi)
     {
         vsg_meshes[mi] = createMesh(root->meshes.values[mi]);
+        numPrimitives += root->meshes.values[mi]->primitives.values.size();
     }
 
-    // vsg::info("create nodes = ", root->nodes.values.size());
-    vsg_nodes.resize(root->nodes.values.size());
-    for(size_t ni=0; ni<root->nodes.values.size(); ++ni)
+    if (report)
+    {
+        vsg::info("gltf::SceneGraphBuilder::createMesh() meshes = ", vsg_meshes.size(), ", primitives = ", numPrimitives, ", pipeline states = ", pipelineStates.size(),
+                  ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - before_meshes).count(), "ms");
+    }
+
+    if (!weldableDraws.empty())
+    {
+        weldVertices(options ? options->operationThreads : vsg::ref_ptr<vsg::OperationThreads>(), report);
+    }
+
+    if (optimizeGeometry)
     {
-        vsg_nodes[ni] = createNode(root->nodes.values[ni]);
+        optimizeTriangles(options ? options->operationThreads : vsg::ref_ptr<vsg::OperationThreads>(), report);
     }
 
-    for(size_t ni=0; ni<root->nodes.values.size(); ++ni)
+    if (!interleavableDraws.empty())
     {
-        auto& gltf_node = root->nodes.values[ni];
+        interleaveVertexArrays(options ? options->operationThreads : vsg::ref_ptr<vsg::OperationThreads>(), report);
+    }
+
+    if (buildClusters)
+    {
+        createClusters(options ? options->operationThreads : vsg::ref_ptr<vsg::OperationThreads>(), report);
+    }
 
-        if (!gltf_node->children.values.empty())
+    // vsg::info("create nodes = ", root->nodes.values.size());
+    if (root->compact)
+    {
+        createNodes(*root->compact);
+    }
+    else
+    {
+        vsg_nodes.resize(root->nodes.values.size());
+        for(size_t ni=0; ni<root->nodes.values.size(); ++ni)
         {
-            auto vsg_group = vsg_nodes[ni].cast<vsg::Group>();
-            for(auto id : gltf_node->children.values)
+            vsg_nodes[ni] = createNode(root->nodes.values[ni]);
+        }
+
+        for(size_t ni=0; ni<root->nodes.values.size(); ++ni)
+        {
+            auto& gltf_node = root->nodes.values[ni];
+
+            if (!gltf_node->children.values.empty())
             {
-                auto vsg_child = vsg_nodes[id.value];
-                if (vsg_child) vsg_group->addChild(vsg_child);
-                else vsg::info("Unassigned vsg_child");
+                auto vsg_group = vsg_nodes[ni].cast<vsg::Group>();
+                for(auto id : gltf_node->children.values)
+                {
+                    auto vsg_child = vsg_nodes[id.value];
+                    if (vsg_child) vsg_group->addChild(vsg_child);
+                    else vsg::info("Unassigned vsg_child");
+                }
             }
         }
     }
@@ -933,7 +1388,30 @@ vsg::ref_ptr<vsg::Object> gltf::SceneGraphBuilder::createSceneGraph(vsg::ref_ptr
         vsg_scenes[sci] = createScene(root->scenes.values[sci]);
     }
 
+    if (flattenStaticTransforms)
+    {
+        flattenTransforms(*root, options ? options->operationThreads : vsg::ref_ptr<vsg::OperationThreads>(), report);
+    }
+
+    if (batchStaticGeometry && !staticPrimitives.empty())
+    {
+        batchGeometry(report);
+    }
+
+    staticPrimitives.clear();
+
+    if (vsg::value<bool>(false, gltf::simplify_graph, options))
+    {
+        simplifySceneGraph(report);
+    }
+
+    if (vsg::value<bool>(false, gltf::sort_state, options))
+    {
+        sortState(report);
+    }
+
     // create root node
+    vsg::ref_ptr<vsg::Node> vsg_root;
     if (vsg_scenes.size() > 1)
     {
         auto vsg_switch = vsg::Switch::create();
@@ -947,12 +1425,1567 @@ vsg::ref_ptr<vsg::Object> gltf::SceneGraphBuilder::createSceneGraph(vsg::ref_ptr
 
         // vsg::info("Created a scenes with a switch");
 
-        return vsg_switch;
+        vsg_root = vsg_switch;
     }
     else
     {
         // vsg::info("Created a single scene");
-        return vsg_scenes.front();
+        vsg_root = vsg_scenes.front();
+    }
+
+    if (vsg_root && vsg::value<bool>(false, gltf::release_buffers, options))
+    {
+        releaseBuffers(*root, *vsg_root, report);
+    }
+
+    return vsg_root;
+}
+
+void gltf::SceneGraphBuilder::downscaleImages(const gltf::glTF& root, uint32_t maxTextureSize, size_t textureBudget, bool mipmaps, vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report)
+{
+    auto start_point = vsg::clock::now();
+
+    // extent of the POSITION bounds of the largest mesh using each image, as a measure of the image's size on screen
+    auto positionExtent = [&](const gltf::Primitive& primitive) -> double
+    {
+        auto itr = primitive.attributes.values.find("POSITION");
+        if (itr == primitive.attributes.values.end() || !itr->second) return 0.0;
+
+        const double* minimum = nullptr;
+        const double* maximum = nullptr;
+        if (root.compact)
+        {
+            auto& accessors = root.compact->accessors;
+            if (itr->second.value >= accessors.size() || accessors.min[itr->second.value].count < 3 || accessors.max[itr->second.value].count < 3) return 0.0;
+            minimum = root.compact->values(accessors.min[itr->second.value]);
+            maximum = root.compact->values(accessors.max[itr->second.value]);
+        }
+        else
+        {
+            if (itr->second.value >= root.accessors.values.size()) return 0.0;
+            auto& accessor = root.accessors.values[itr->second.value];
+            if (!accessor || accessor->min.values.size() < 3 || accessor->max.values.size() < 3) return 0.0;
+            minimum = accessor->min.values.data();
+            maximum = accessor->max.values.data();
+        }
+
+        return vsg::length(vsg::dvec3(maximum[0] - minimum[0], maximum[1] - minimum[1], maximum[2] - minimum[2]));
+    };
+
+    std::vector<double> extents(vsg_images.size(), 0.0);
+    for(auto& mesh : root.meshes.values)
+    {
+        if (!mesh) continue;
+
+        for(auto& primitive : mesh->primitives.values)
+        {
+            if (!primitive || !primitive->material || primitive->material.value >= root.materials.values.size()) continue;
+
+            auto& material = root.materials.values[primitive->material.value];
+            if (!material) continue;
+
+            double extent = positionExtent(*primitive);
+            for(auto texture : {&material->pbrMetallicRoughness.baseColorTexture.index, &material->pbrMetallicRoughness.metallicRoughnessTexture.index,
+                                &material->normalTexture.index, &material->occlusionTexture.index, &material->emissiveTexture.index})
+            {
+                if (auto ii = textureImage(root, *texture); ii < vsg_images.size()) extents[ii] = std::max(extents[ii], extent);
+            }
+        }
+    }
+
+    // images without bounds are given the average extent of the others
+    double extentSum = 0.0;
+    size_t numExtents = 0;
+    for(auto extent : extents)
+    {
+        if (extent > 0.0) { extentSum += extent; ++numExtents; }
+    }
+    for(auto& extent : extents)
+    {
+        if (extent == 0.0) extent = numExtents > 0 ? extentSum / static_cast<double>(numExtents) : 1.0;
+    }
+
+    // sizes of the images once uploaded, as RGBA with a third more for mipmaps
+    auto gpuSize = [&](uint32_t width, uint32_t height) -> size_t
+    {
+        size_t size = static_cast<size_t>(width) * height * 4;
+        return mipmaps ? size + size / 3 : size;
+    };
+
+    std::vector<uint32_t> widths(vsg_images.size(), 0), heights(vsg_images.size(), 0);
+    size_t fixedSize = 0;
+    size_t totalSize = 0;
+    for(size_t i = 0; i < vsg_images.size(); ++i)
+    {
+        auto& image = vsg_images[i];
+        if (!image) continue;
+
+        if (!ImagePreparer::supported(*image))
+        {
+            fixedSize += image->dataSize();
+            continue;
+        }
+
+        widths[i] = image->width();
+        heights[i] = image->height();
+        while (maxTextureSize > 0 && std::max(widths[i], heights[i]) > maxTextureSize)
+        {
+            widths[i] = std::max(1u, widths[i] / 2);
+            heights[i] = std::max(1u, heights[i] / 2);
+        }
+        totalSize += gpuSize(widths[i], heights[i]);
+    }
+
+    // halve the image with the most pixels for the area its meshes cover on screen, the square of their extent, until the images fit the budget
+    constexpr uint32_t minTextureSize = 64;
+    auto density = [&](size_t i) { return static_cast<double>(widths[i]) * heights[i] / (extents[i] * extents[i]); };
+    auto lessDense = [&](size_t lhs, size_t rhs) { return density(lhs) < density(rhs); };
+
+    std::priority_queue<size_t, std::vector<size_t>, decltype(lessDense)> candidates(lessDense);
+    if (textureBudget > 0)
+    {
+        for(size_t i = 0; i < vsg_images.size(); ++i)
+        {
+            if (std::max(widths[i], heights[i]) > minTextureSize) candidates.push(i);
+        }
+    }
+
+    while (fixedSize + totalSize > textureBudget && !candidates.empty())
+    {
+        size_t i = candidates.top();
+        candidates.pop();
+
+        totalSize -= gpuSize(widths[i], heights[i]);
+        widths[i] = std::max(1u, widths[i] / 2);
+        heights[i] = std::max(1u, heights[i] / 2);
+        totalSize += gpuSize(widths[i], heights[i]);
+
+        if (std::max(widths[i], heights[i]) > minTextureSize) candidates.push(i);
+    }
+
+    std::vector<vsg::ref_ptr<vsg::Data>> downscaled(vsg_images.size());
+    gltf::parallel_for(operationThreads, vsg_images.size(), [&](size_t i)
+    {
+        if (vsg_images[i] && widths[i] > 0) downscaled[i] = ImagePreparer::downscale(vsg_images[i], widths[i], heights[i]);
+    });
+
+    size_t numDownscaled = 0;
+    size_t bytesBefore = 0;
+    size_t bytesAfter = 0;
+    for(size_t i = 0; i < vsg_images.size(); ++i)
+    {
+        if (!downscaled[i] || downscaled[i] == vsg_images[i]) continue;
+
+        ++numDownscaled;
+        bytesBefore += vsg_images[i]->dataSize();
+        bytesAfter += downscaled[i]->dataSize();
+        vsg_images[i] = downscaled[i];
+    }
+
+    if (report)
+    {
+        vsg::info("gltf::SceneGraphBuilder::downscaleImages() images = ", numDownscaled, ", bytes saved = ", bytesBefore - bytesAfter, ", texture memory = ", fixedSize + totalSize,
+                  ", budget = ", textureBudget, ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_point).count(), "ms");
+    }
+    else if (textureBudget > 0 && fixedSize + totalSize > textureBudget)
+    {
+        vsg::warn("gltf::SceneGraphBuilder::downscaleImages() texture memory of ", fixedSize + totalSize, " bytes exceeds the budget of ", textureBudget, " bytes.");
+    }
+}
+
+void gltf::SceneGraphBuilder::prepareImages(vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report)
+{
+    auto start_point = vsg::clock::now();
+
+    // images used by several textures are only prepared once as they share the same vsg_images entry
+    std::vector<vsg::ref_ptr<vsg::Data>> prepared(vsg_images.size());
+    gltf::parallel_for(operationThreads, vsg_images.size(), [&](size_t i)
+    {
+        prepared[i] = imagePreparer.prepare(vsg_images[i]);
+    });
+
+    size_t numPrepared = 0;
+    size_t bytesBefore = 0;
+    size_t bytesAfter = 0;
+    for(size_t i = 0; i < vsg_images.size(); ++i)
+    {
+        if (prepared[i] == vsg_images[i]) continue;
+
+        ++numPrepared;
+        bytesBefore += vsg_images[i]->dataSize();
+        bytesAfter += prepared[i]->dataSize();
+        vsg_images[i] = prepared[i];
+    }
+
+    if (report)
+    {
+        vsg::info("gltf::SceneGraphBuilder::prepareImages() images = ", numPrepared, ", bytes before = ", bytesBefore, ", after = ", bytesAfter,
+                  ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_point).count(), "ms");
+    }
+}
+
+void gltf::SceneGraphBuilder::compressImages(const gltf::glTF& root, vsg::ref_ptr<const vsg::Options> options, bool report)
+{
+    auto start_point = vsg::clock::now();
+
+    // images only referenced as normal maps may be encoded as two channels
+    std::vector<bool> normalMaps(vsg_images.size(), false), colors(vsg_images.size(), false);
+    for(auto& material : root.materials.values)
+    {
+        if (!material) continue;
+
+        if (auto ni = textureImage(root, material->normalTexture.index); ni < vsg_images.size()) normalMaps[ni] = true;
+        for(auto texture : {&material->pbrMetallicRoughness.baseColorTexture.index, &material->pbrMetallicRoughness.metallicRoughnessTexture.index,
+                            &material->occlusionTexture.index, &material->emissiveTexture.index})
+        {
+            if (auto ci = textureImage(root, *texture); ci < vsg_images.size()) colors[ci] = true;
+        }
+    }
+
+    std::vector<BlockCompressor::Result> results(vsg_images.size());
+    gltf::parallel_for(options ? options->operationThreads : vsg::ref_ptr<vsg::OperationThreads>(), vsg_images.size(), [&](size_t i)
+    {
+        auto usage = (normalMaps[i] && !colors[i]) ? BlockCompressor::NORMAL_MAP : BlockCompressor::COLOR;
+        results[i] = blockCompressor.compress(vsg_images[i], usage, options);
+    });
+
+    size_t numCompressed = 0;
+    size_t numCached = 0;
+    size_t bytesBefore = 0;
+    size_t bytesAfter = 0;
+    for(size_t i = 0; i < vsg_images.size(); ++i)
+    {
+        if (results[i].image == vsg_images[i]) continue;
+
+        ++numCompressed;
+        if (results[i].cached) ++numCached;
+        bytesBefore += vsg_images[i]->dataSize();
+        bytesAfter += results[i].image->dataSize();
+        vsg_images[i] = results[i].image;
+    }
+
+    if (report)
+    {
+        vsg::info("gltf::SceneGraphBuilder::compressImages() images = ", numCompressed, ", read from cache = ", numCached, ", bytes before = ", bytesBefore,
+                  ", after = ", bytesAfter, ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_point).count(), "ms");
+    }
+}
+
+void gltf::SceneGraphBuilder::weldVertices(vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report)
+{
+    auto start_point = vsg::clock::now();
+
+    std::vector<VertexWelder::Result> results(weldableDraws.size());
+
+    // weld large draws one at a time with the work for each spread across the threads, and the small draws concurrently with each other
+    std::vector<size_t> smallDraws;
+    for(size_t i = 0; i < weldableDraws.size(); ++i)
+    {
+        auto& weldable = weldableDraws[i];
+        if (weldable.numVertices >= vertexWelder.minParallelVertices) results[i] = vertexWelder.weld(weldable.arrays, weldable.numVertices, operationThreads);
+        else smallDraws.push_back(i);
+    }
+
+    gltf::parallel_for(operationThreads, smallDraws.size(), [&](size_t i)
+    {
+        auto& weldable = weldableDraws[smallDraws[i]];
+        results[smallDraws[i]] = vertexWelder.weld(weldable.arrays, weldable.numVertices, {});
+    });
+
+    std::map<const vsg::VertexIndexDraw*, size_t> weldedDraws;
+    size_t verticesBefore = 0;
+    size_t verticesAfter = 0;
+    for(size_t i = 0; i < weldableDraws.size(); ++i)
+    {
+        auto& weldable = weldableDraws[i];
+        auto& result = results[i];
+        if (!result.indices) continue;
+
+        weldable.vid->assignArrays(result.arrays);
+        weldable.vid->assignIndices(result.indices);
+        weldable.vid->indexCount = weldable.numVertices;
+
+        weldedDraws[weldable.vid.get()] = i;
+        verticesBefore += weldable.numVertices;
+        verticesAfter += result.numVertices;
+    }
+
+    // point the later stages at the welded positions
+    auto weldedPositions = [&](const vsg::VertexIndexDraw* vid, vsg::ref_ptr<vsg::vec3Array>& positions)
+    {
+        auto itr = weldedDraws.find(vid);
+        if (itr == weldedDraws.end() || !positions) return;
+
+        auto& weldable = weldableDraws[itr->second];
+        for(size_t a = 0; a < weldable.arrays.size(); ++a)
+        {
+            if (weldable.arrays[a] == positions)
+            {
+                positions = results[itr->second].arrays[a].cast<vsg::vec3Array>();
+                return;
+            }
+        }
+    };
+
+    for(auto& triangles : optimizableTriangles) weldedPositions(triangles.vid.get(), triangles.positions);
+    for(auto& triangles : clusterableTriangles) weldedPositions(triangles.vid.get(), triangles.positions);
+
+    if (report)
+    {
+        vsg::info("gltf::SceneGraphBuilder::weldVertices() primitives = ", weldedDraws.size(), ", vertices before = ", verticesBefore, ", after = ", verticesAfter,
+                  ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_point).count(), "ms");
+    }
+
+    weldableDraws.clear();
+}
+
+gltf::GeometryOptimizer::Statistics gltf::SceneGraphBuilder::optimizeTriangles(vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report)
+{
+    auto start_point = vsg::clock::now();
+
+    std::vector<GeometryOptimizer::Statistics> statistics(optimizableTriangles.size());
+    std::vector<vsg::ref_ptr<vsg::vec3Array>> reorderedPositions(optimizableTriangles.size());
+
+    gltf::parallel_for(operationThreads, optimizableTriangles.size(), [&](size_t i)
+    {
+        auto& triangles = optimizableTriangles[i];
+
+        // arrays shared with other primitives would be duplicated by reordering them
+        bool reorderVertices = true;
+        size_t positionArray = triangles.vid->arrays.size();
+        for(size_t a = 0; a < triangles.vid->arrays.size(); ++a)
+        {
+            auto& bufferInfo = triangles.vid->arrays[a];
+            if (!bufferInfo) continue;
+            if (bufferInfo->data == triangles.positions) positionArray = a;
+
+            auto usage_itr = vertexArrayUsage.find(bufferInfo->data.get());
+            if (usage_itr != vertexArrayUsage.end() && usage_itr->second > 1) reorderVertices = false;
+        }
+
+        geometryOptimizer.optimize(*triangles.vid, triangles.positions, reorderVertices, statistics[i]);
+
+        if (positionArray < triangles.vid->arrays.size()) reorderedPositions[i] = triangles.vid->arrays[positionArray]->data.cast<vsg::vec3Array>();
+    });
+
+    // point the clusters at the reordered positions
+    std::map<const vsg::VertexIndexDraw*, vsg::ref_ptr<vsg::vec3Array>> optimizedPositions;
+    for(size_t i = 0; i < optimizableTriangles.size(); ++i)
+    {
+        if (reorderedPositions[i]) optimizedPositions[optimizableTriangles[i].vid.get()] = reorderedPositions[i];
+    }
+    for(auto& triangles : clusterableTriangles)
+    {
+        if (auto itr = optimizedPositions.find(triangles.vid.get()); itr != optimizedPositions.end()) triangles.positions = itr->second;
+    }
+
+    GeometryOptimizer::Statistics total;
+    for(auto& local : statistics) total += local;
+
+    if (report)
+    {
+        vsg::info("gltf::SceneGraphBuilder::optimizeTriangles() primitives = ", total.numPrimitives, ", triangles = ", total.numTriangles, ", indices narrowed to uint16 = ", total.numNarrowed,
+                  ", ACMR before = ", total.acmrBefore(), ", after = ", total.acmrAfter(), ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_point).count(), "ms");
+    }
+
+    optimizableTriangles.clear();
+    vertexArrayUsage.clear();
+
+    return total;
+}
+
+void gltf::SceneGraphBuilder::interleaveVertexArrays(vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report)
+{
+    auto start_point = vsg::clock::now();
+
+    auto drawArrays = [](vsg::Command& draw) -> vsg::BufferInfoList*
+    {
+        if (auto vid = draw.cast<vsg::VertexIndexDraw>()) return &vid->arrays;
+        if (auto vd = draw.cast<vsg::VertexDraw>()) return &vd->arrays;
+        return nullptr;
+    };
+
+    // primitives sharing the same vertex arrays share the interleaved array
+    struct Interleaving
+    {
+        vsg::DataList arrays;
+        const InterleavableDraw* layout = nullptr;
+        vsg::ref_ptr<vsg::Data> interleaved;
+        bool sourceView = false;
+    };
+
+    std::map<vsg::DataList, size_t> interleavingIndices;
+    std::vector<Interleaving> interleavings;
+    static constexpr size_t no_interleaving = std::numeric_limits<size_t>::max();
+    std::vector<size_t> drawInterleavings(interleavableDraws.size(), no_interleaving);
+    for(size_t i = 0; i < interleavableDraws.size(); ++i)
+    {
+        auto& interleavable = interleavableDraws[i];
+        auto bufferInfos = drawArrays(*interleavable.draw);
+        if (!bufferInfos || bufferInfos->size() < interleavable.offsets.size()) continue;
+
+        vsg::DataList arrays;
+        for(size_t a = 0; a < interleavable.offsets.size(); ++a)
+        {
+            auto& bufferInfo = (*bufferInfos)[a];
+            arrays.push_back(bufferInfo ? bufferInfo->data : vsg::ref_ptr<vsg::Data>());
+        }
+
+        auto [itr, inserted] = interleavingIndices.emplace(arrays, interleavings.size());
+        if (inserted) interleavings.push_back(Interleaving{arrays, &interleavable, {}, false});
+        drawInterleavings[i] = itr->second;
+    }
+
+    gltf::parallel_for(operationThreads, interleavings.size(), [&](size_t i)
+    {
+        auto& interleaving = interleavings[i];
+        auto& layout = *interleaving.layout;
+        size_t numVertices = interleaving.arrays.front()->valueCount();
+
+        // the interleaved array is a view of the first array's type stepping over whole vertices, so it's uploaded as one buffer while ComputeBounds still sees the positions
+        auto createInterleaved = [&](vsg::ref_ptr<vsg::Data> storage, uint32_t offset)
+        {
+            if (auto interleaved = createArrayView(*interleaving.arrays.front(), storage, offset, layout.stride, static_cast<uint32_t>(numVertices))) return interleaved;
+            return vsg::ref_ptr<vsg::Data>(vsg::ubyteArray::create(storage, offset, 1, static_cast<uint32_t>(numVertices * layout.stride)));
+        };
+
+        // reuse the source data when welding and optimization have left it interleaved in the layout assigned to the pipeline
+        std::vector<uint32_t> offsets;
+        uint32_t stride = 0;
+        const uint8_t* base = nullptr;
+        if (sourceInterleaving(interleaving.arrays, offsets, stride, base) && offsets == layout.offsets && stride == layout.stride)
+        {
+            auto storage = interleaving.arrays.front()->storage();
+            interleaving.interleaved = createInterleaved(vsg::ref_ptr<vsg::Data>(storage), static_cast<uint32_t>(base - static_cast<const uint8_t*>(storage->dataPointer())));
+            interleaving.sourceView = true;
+            return;
+        }
+
+        auto storage = vsg::ubyteArray::create(static_cast<uint32_t>(numVertices * layout.stride));
+        std::memset(storage->dataPointer(), 0, storage->dataSize());
+
+        auto ptr = static_cast<uint8_t*>(storage->dataPointer());
+        for(size_t v = 0; v < numVertices; ++v, ptr += layout.stride)
+        {
+            for(size_t a = 0; a < interleaving.arrays.size(); ++a)
+            {
+                auto& data = interleaving.arrays[a];
+                std::memcpy(ptr + layout.offsets[a], data->dataPointer(v), data->valueSize());
+            }
+        }
+        interleaving.interleaved = createInterleaved(storage, 0);
+    });
+
+    size_t numDraws = 0;
+    size_t bindingsRemoved = 0;
+    for(size_t i = 0; i < interleavableDraws.size(); ++i)
+    {
+        if (drawInterleavings[i] == no_interleaving) continue;
+
+        auto& interleavable = interleavableDraws[i];
+        auto bufferInfos = drawArrays(*interleavable.draw);
+
+        vsg::DataList arrays;
+        arrays.push_back(interleavings[drawInterleavings[i]].interleaved);
+        for(size_t a = interleavable.offsets.size(); a < bufferInfos->size(); ++a)
+        {
+            arrays.push_back((*bufferInfos)[a]->data);
+        }
+
+        if (auto vid = interleavable.draw.cast<vsg::VertexIndexDraw>()) vid->assignArrays(arrays);
+        else if (auto vd = interleavable.draw.cast<vsg::VertexDraw>()) vd->assignArrays(arrays);
+
+        ++numDraws;
+        bindingsRemoved += interleavable.offsets.size() - 1;
+    }
+
+    if (report)
+    {
+        size_t numSourceViews = 0;
+        size_t bytesCopied = 0;
+        for(auto& interleaving : interleavings)
+        {
+            if (interleaving.sourceView) ++numSourceViews;
+            else bytesCopied += interleaving.arrays.front()->valueCount() * interleaving.layout->stride;
+        }
+
+        vsg::info("gltf::SceneGraphBuilder::interleaveVertexArrays() primitives = ", numDraws, ", vertex bindings removed = ", bindingsRemoved, ", interleaved arrays = ", interleavings.size(),
+                  " of which source views = ", numSourceViews, ", bytes copied = ", bytesCopied,
+                  ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_point).count(), "ms");
+    }
+
+    interleavableDraws.clear();
+}
+
+void gltf::SceneGraphBuilder::createClusters(vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report)
+{
+    auto start_point = vsg::clock::now();
+
+    std::vector<vsg::ref_ptr<vsg::Node>> clusters(clusterableTriangles.size());
+
+    gltf::parallel_for(operationThreads, clusterableTriangles.size(), [&](size_t i)
+    {
+        auto& triangles = clusterableTriangles[i];
+        clusters[i] = clusterBuilder.createClusters(*triangles.vid, *triangles.positions, triangles.backFaceCulling);
+    });
+
+    size_t numPrimitives = 0;
+    size_t numClusters = 0;
+    for(size_t i = 0; i < clusterableTriangles.size(); ++i)
+    {
+        if (!clusters[i]) continue;
+
+        auto& triangles = clusterableTriangles[i];
+        for(auto& child : triangles.stateGroup->children)
+        {
+            if (child == triangles.vid)
+            {
+                if (auto extras = triangles.vid->getRefObject("extras")) clusters[i]->setObject("extras", extras);
+                child = clusters[i];
+            }
+        }
+
+        ++numPrimitives;
+        numClusters += clusters[i].cast<vsg::Group>()->children.size() - 2;
+    }
+
+    if (report)
+    {
+        vsg::info("gltf::SceneGraphBuilder::createClusters() primitives = ", numPrimitives, " of ", clusterableTriangles.size(), ", clusters = ", numClusters,
+                  ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_point).count(), "ms");
+    }
+
+    clusterableTriangles.clear();
+}
+
+namespace
+{
+    // create an array of the same type and format as the visited array
+    struct CreateCompatibleArray : public vsg::Visitor
+    {
+        uint32_t numElements = 0;
+        vsg::ref_ptr<vsg::Data> result;
+
+        // when set a view onto storage is created rather than an array with its own memory
+        vsg::ref_ptr<vsg::Data> storage;
+        uint32_t offset = 0;
+        uint32_t stride = 0;
+
+        template<class A>
+        void create(A& array)
+        {
+            if (storage)
+            {
+                auto view = A::create(storage, offset, stride, numElements);
+                view->properties = array.properties;
+                view->properties.stride = stride;
+
+                result = view;
+                return;
+            }
+
+            auto new_array = A::create(numElements);
+
+            auto stride = new_array->properties.stride;
+            new_array->properties = array.properties;
+            new_array->properties.stride = stride;
+
+            result = new_array;
+        }
+
+        void apply(vsg::byteArray& array) override { create(array); }
+        void apply(vsg::ubyteArray& array) override { create(array); }
+        void apply(vsg::shortArray& array) override { create(array); }
+        void apply(vsg::ushortArray& array) override { create(array); }
+        void apply(vsg::uintArray& array) override { create(array); }
+        void apply(vsg::floatArray& array) override { create(array); }
+        void apply(vsg::vec2Array& array) override { create(array); }
+        void apply(vsg::vec3Array& array) override { create(array); }
+        void apply(vsg::vec4Array& array) override { create(array); }
+        void apply(vsg::bvec2Array& array) override { create(array); }
+        void apply(vsg::bvec3Array& array) override { create(array); }
+        void apply(vsg::bvec4Array& array) override { create(array); }
+        void apply(vsg::ubvec2Array& array) override { create(array); }
+        void apply(vsg::ubvec3Array& array) override { create(array); }
+        void apply(vsg::ubvec4Array& array) override { create(array); }
+        void apply(vsg::svec2Array& array) override { create(array); }
+        void apply(vsg::svec3Array& array) override { create(array); }
+        void apply(vsg::svec4Array& array) override { create(array); }
+        void apply(vsg::usvec2Array& array) override { create(array); }
+        void apply(vsg::usvec3Array& array) override { create(array); }
+        void apply(vsg::usvec4Array& array) override { create(array); }
+        void apply(vsg::uivec2Array& array) override { create(array); }
+        void apply(vsg::uivec3Array& array) override { create(array); }
+        void apply(vsg::uivec4Array& array) override { create(array); }
+        void apply(vsg::mat4Array& array) override { create(array); }
+    };
+
+    // copy arrays that are views into another vsg::Data into right-sized arrays, sharing the copy between all users of the same view
+    struct CompactArrays
+    {
+        // byte range of a storage covered by interleaved views, and the copy of it they're rebuilt on
+        struct Span
+        {
+            size_t begin = 0;
+            size_t end = 0;
+            vsg::ref_ptr<vsg::Data> copy;
+        };
+
+        std::map<const vsg::Data*, std::vector<Span>> spans; // by storage
+        std::map<const vsg::Data*, vsg::ref_ptr<vsg::Data>> copies;
+        size_t compactedSize = 0;
+        size_t numRetained = 0;
+
+        static bool interleaved(const vsg::Data& data) { return data.storage() && data.properties.stride > data.valueSize() && data.valueCount() > 0; }
+
+        // byte range of the storage covered by the view
+        static std::pair<size_t, size_t> range(const vsg::Data& data)
+        {
+            size_t begin = static_cast<const uint8_t*>(data.dataPointer()) - static_cast<const uint8_t*>(data.storage()->dataPointer());
+            return {begin, begin + (data.valueCount() - 1) * data.properties.stride + data.valueSize()};
+        }
+
+        // first pass, record the ranges covered by the interleaved views of each storage
+        void collect(const vsg::ref_ptr<vsg::Data>& data)
+        {
+            if (!data || !interleaved(*data)) return;
+
+            auto [begin, end] = range(*data);
+            spans[data->storage()].push_back(Span{begin, end, {}});
+        }
+
+        // merge the overlapping ranges of each storage and copy each merged span once, so views interleaved in the same vertices share a copy
+        void copySpans()
+        {
+            for(auto& [storage, storageSpans] : spans)
+            {
+                std::sort(storageSpans.begin(), storageSpans.end(), [](const Span& lhs, const Span& rhs) { return lhs.begin < rhs.begin; });
+
+                std::vector<Span> merged;
+                for(auto& span : storageSpans)
+                {
+                    if (!merged.empty() && span.begin < merged.back().end) merged.back().end = std::max(merged.back().end, span.end);
+                    else merged.push_back(span);
+                }
+
+                for(auto& span : merged)
+                {
+                    // storage that's already exactly the span is kept as is
+                    if (merged.size() == 1 && span.begin == 0 && span.end == storage->dataSize() && !storage->storage())
+                    {
+                        span.copy = const_cast<vsg::Data*>(storage);
+                        continue;
+                    }
+
+                    size_t size = span.end - span.begin;
+                    span.copy = vsg::ubyteArray::create(static_cast<uint32_t>(size));
+                    std::memcpy(span.copy->dataPointer(), static_cast<const uint8_t*>(storage->dataPointer()) + span.begin, size);
+                    compactedSize += size;
+                }
+
+                storageSpans.swap(merged);
+            }
+        }
+
+        // second pass, return the compacted replacement of data
+        vsg::ref_ptr<vsg::Data> compact(vsg::ref_ptr<vsg::Data> data)
+        {
+            // arrays that own their memory are left as is
+            if (!data || !data->storage()) return data;
+
+            auto& compacted = copies[data.get()];
+            if (compacted) return compacted;
+
+            if (interleaved(*data))
+            {
+                // interleaved views keep their stride as the pipeline's vertex bindings were set up with it, so rebuild them on the copy of their span
+                auto [begin, end] = range(*data);
+                for(auto& span : spans[data->storage()])
+                {
+                    if (begin >= span.begin && end <= span.end)
+                    {
+                        compacted = gltf::createArrayView(*data, span.copy, static_cast<uint32_t>(begin - span.begin), data->properties.stride, static_cast<uint32_t>(data->valueCount()));
+                        break;
+                    }
+                }
+
+                if (!compacted)
+                {
+                    compacted = data;
+                    ++numRetained;
+                }
+                return compacted;
+            }
+
+            if (auto copy = gltf::createCompatibleArray(*data, static_cast<uint32_t>(data->valueCount())))
+            {
+                gltf::copyValues(*data, 0, *copy, 0, data->valueCount());
+                compactedSize += copy->dataSize();
+                compacted = copy;
+            }
+            else
+            {
+                compacted = data;
+                ++numRetained;
+            }
+            return compacted;
+        }
+    };
+
+    // replace the vertex, index and image data in the scene graph with compacted copies
+    struct ReplaceBufferViews : public vsg::Visitor
+    {
+        CompactArrays compactArrays;
+        bool collecting = true; // first traversal collects the interleaved views, the second replaces the data
+
+        void compact(vsg::ref_ptr<vsg::Data>& data)
+        {
+            if (collecting) compactArrays.collect(data);
+            else data = compactArrays.compact(data);
+        }
+
+        void compact(vsg::BufferInfoList& arrays)
+        {
+            for(auto& bufferInfo : arrays)
+            {
+                if (bufferInfo) compact(bufferInfo->data);
+            }
+        }
+
+        void compact(vsg::ref_ptr<vsg::BufferInfo>& bufferInfo)
+        {
+            if (bufferInfo) compact(bufferInfo->data);
+        }
+
+        void apply(vsg::Object& object) override { object.traverse(*this); }
+
+        void apply(vsg::VertexIndexDraw& vid) override
+        {
+            compact(vid.arrays);
+            compact(vid.indices);
+        }
+
+        void apply(vsg::VertexDraw& vd) override
+        {
+            compact(vd.arrays);
+        }
+
+        void apply(vsg::Geometry& geometry) override
+        {
+            compact(geometry.arrays);
+            compact(geometry.indices);
+        }
+
+        void apply(vsg::BindVertexBuffers& bvb) override
+        {
+            compact(bvb.arrays);
+        }
+
+        void apply(vsg::BindIndexBuffer& bib) override
+        {
+            compact(bib.indices);
+        }
+
+        void apply(vsg::DescriptorImage& di) override
+        {
+            for(auto& imageInfo : di.imageInfoList)
+            {
+                if (imageInfo && imageInfo->imageView && imageInfo->imageView->image)
+                {
+                    compact(imageInfo->imageView->image->data);
+                }
+            }
+        }
+    };
+}
+
+void gltf::SceneGraphBuilder::flattenTransforms(const gltf::glTF& root, vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report)
+{
+    auto start_point = vsg::clock::now();
+
+    struct CountTransforms : public vsg::ConstVisitor
+    {
+        size_t numTransforms = 0;
+
+        void apply(const vsg::Node& node) override { node.traverse(*this); }
+        void apply(const vsg::MatrixTransform& transform) override
+        {
+            ++numTransforms;
+            transform.traverse(*this);
+        }
+    };
+
+    CountTransforms transformsBefore;
+    if (report)
+    {
+        for(auto& scene : vsg_scenes) if (scene) scene->accept(transformsBefore);
+    }
+
+    // the nodes that are animated, skin joints or hold cameras or skins keep their transforms
+    std::set<const vsg::Node*> preservedNodes;
+    auto preserve = [&](glTFid id)
+    {
+        if (id && id.value < vsg_nodes.size() && vsg_nodes[id.value]) preservedNodes.insert(vsg_nodes[id.value].get());
+    };
+
+    for(auto& animation : root.animations.values)
+    {
+        for(auto& channel : animation->channels.values) preserve(channel->target.node);
+    }
+
+    for(auto& skin : root.skins.values)
+    {
+        preserve(skin->skeleton);
+        for(auto& joint : skin->joints.values) preserve(joint);
+    }
+
+    for(size_t ni = 0; ni < vsg_nodes.size(); ++ni)
+    {
+        bool hasCameraOrSkin = false;
+        if (root.compact) hasCameraOrSkin = root.compact->nodes.camera[ni] || root.compact->nodes.skin[ni];
+        else if (ni < root.nodes.values.size()) hasCameraOrSkin = root.nodes.values[ni]->camera || root.nodes.values[ni]->skin;
+
+        if (hasCameraOrSkin) preserve(glTFid{static_cast<uint32_t>(ni)});
+    }
+
+    // nodes with more than one parent are instanced so can't have a transform baked into them
+    std::map<const vsg::Node*, uint32_t> references;
+    for(auto& scene : vsg_scenes) if (scene) countReferences(*scene, references);
+
+    std::vector<std::pair<GeometryBatcher::Primitive, vsg::dmat4>> bakes;
+    size_t numTransformsRemoved = 0;
+
+    struct Flattened
+    {
+        vsg::ref_ptr<vsg::Node> node;
+        bool transformed = false; // true if node includes the matrix it was flattened with, otherwise it must be placed below a transform of it
+    };
+
+    const vsg::dmat4 identity;
+    std::set<const vsg::Node*> flattenedInstances;
+    std::function<Flattened(vsg::ref_ptr<vsg::Node>, const vsg::dmat4&)> flatten;
+
+    // replace the children of group with their flattened versions, with any that don't include matrix placed below the returned transform
+    auto flattenChildren = [&](vsg::Group& group, const vsg::dmat4& matrix, vsg::ref_ptr<vsg::MatrixTransform> transform) -> vsg::ref_ptr<vsg::MatrixTransform>
+    {
+        decltype(group.children) transformed, untransformed;
+        for(auto& child : group.children)
+        {
+            auto flattened = flatten(child, matrix);
+            if (flattened.transformed || matrix == identity) transformed.push_back(flattened.node);
+            else untransformed.push_back(flattened.node);
+        }
+
+        group.children = transformed;
+        if (untransformed.empty()) return {};
+
+        if (!transform) transform = vsg::MatrixTransform::create(matrix);
+        transform->matrix = matrix;
+        transform->children = untransformed;
+        return transform;
+    };
+
+    flatten = [&](vsg::ref_ptr<vsg::Node> node, const vsg::dmat4& matrix) -> Flattened
+    {
+        if (references[node.get()] > 1)
+        {
+            // flatten below an instanced node just once, leaving it below a transform of matrix
+            if (flattenedInstances.insert(node.get()).second)
+            {
+                if (auto group = node.cast<vsg::Group>()) flattenChildren(*group, identity, {});
+            }
+            return {node, matrix == identity};
+        }
+
+        if (auto stateGroup = node.cast<vsg::StateGroup>())
+        {
+            if (matrix == identity) return {node, true};
+            if (stateGroup->children.size() != 1 || preservedNodes.count(node.get()) > 0) return {node, false};
+
+            auto itr = staticPrimitives.find(stateGroup->children.front()->cast<vsg::Command>());
+            if (itr == staticPrimitives.end() || !TransformFlattener::bakeable(itr->second, matrix)) return {node, false};
+
+            bakes.emplace_back(itr->second, matrix);
+            return {node, true};
+        }
+        else if (auto transform = node.cast<vsg::MatrixTransform>())
+        {
+            if (preservedNodes.count(node.get()) > 0)
+            {
+                flattenChildren(*transform, identity, {});
+                return {node, false};
+            }
+
+            // the children that couldn't have the matrix baked into them are left below this transform with the matrices above collapsed into it
+            auto childMatrix = matrix * transform->matrix;
+            auto group = vsg::Group::create();
+            group->children = transform->children;
+            if (auto untransformed = flattenChildren(*group, childMatrix, transform))
+            {
+                if (group->children.empty()) return {untransformed, true};
+
+                group->addChild(untransformed);
+                return {group, true};
+            }
+
+            ++numTransformsRemoved;
+
+            // keep a group in place of the transform to hold its name and extras
+            if (auto auxiliary = transform->getAuxiliary())
+            {
+                group->getOrCreateAuxiliary()->userObjects = auxiliary->userObjects;
+                return {group, true};
+            }
+
+            if (group->children.size() == 1) return {group->children.front(), true};
+            return {group, true};
+        }
+        else if (node->cast<vsg::Transform>())
+        {
+            return {node, false};
+        }
+        else if (auto group = node.cast<vsg::Group>())
+        {
+            if (preservedNodes.count(node.get()) > 0)
+            {
+                flattenChildren(*group, identity, {});
+                return {node, false};
+            }
+
+            if (auto untransformed = flattenChildren(*group, matrix, {}))
+            {
+                if (group->children.empty())
+                {
+                    group->children = untransformed->children;
+                    return {node, false};
+                }
+                group->addChild(untransformed);
+            }
+            return {node, true};
+        }
+        else if (auto cullNode = node.cast<vsg::CullNode>())
+        {
+            if (cullNode->child) cullNode->child = flatten(cullNode->child, identity).node;
+            return {node, matrix == identity};
+        }
+
+        return {node, matrix == identity};
+    };
+
+    for(auto& scene : vsg_scenes)
+    {
+        if (scene) scene = flatten(scene, identity).node;
+    }
+
+    gltf::parallel_for(operationThreads, bakes.size(), [&](size_t i)
+    {
+        TransformFlattener::bake(bakes[i].first, bakes[i].second);
+    });
+
+    if (report)
+    {
+        CountTransforms transformsAfter;
+        for(auto& scene : vsg_scenes) if (scene) scene->accept(transformsAfter);
+
+        vsg::info("gltf::SceneGraphBuilder::flattenTransforms() transforms removed = ", numTransformsRemoved, ", primitives baked = ", bakes.size(),
+                  ", transforms before = ", transformsBefore.numTransforms, ", after = ", transformsAfter.numTransforms,
+                  ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_point).count(), "ms");
+    }
+}
+
+void gltf::SceneGraphBuilder::batchGeometry(bool report)
+{
+    auto start_point = vsg::clock::now();
+
+    struct CountDraws : public vsg::ConstVisitor
+    {
+        size_t numDraws = 0;
+
+        void apply(const vsg::Node& node) override { node.traverse(*this); }
+        void apply(const vsg::VertexIndexDraw&) override { ++numDraws; }
+        void apply(const vsg::VertexDraw&) override { ++numDraws; }
+        void apply(const vsg::DrawIndexed&) override { ++numDraws; }
+        void apply(const vsg::Draw&) override { ++numDraws; }
+    };
+
+    CountDraws drawsBefore;
+    if (report)
+    {
+        for(auto& scene : vsg_scenes) if (scene) scene->accept(drawsBefore);
+    }
+
+    // anything below nodes other than groups, matrix transforms and cull nodes may be switched, sorted or moved so is left in place
+    std::set<const vsg::Node*> dynamicNodes;
+    std::function<void(vsg::Node&)> markDynamic = [&](vsg::Node& node)
+    {
+        if (!dynamicNodes.insert(&node).second) return;
+
+        Children children;
+        node.traverse(children);
+        for(auto child : children.nodes) markDynamic(*child);
+    };
+
+    auto batchableStateGroup = [&](vsg::Node& node) -> vsg::StateGroup*
+    {
+        auto stateGroup = node.cast<vsg::StateGroup>();
+        if (!stateGroup || stateGroup->children.size() != 1) return nullptr;
+
+        auto draw = stateGroup->children.front()->cast<vsg::Command>();
+        return (draw && staticPrimitives.count(draw) > 0) ? stateGroup : nullptr;
+    };
+
+    struct Occurrence
+    {
+        vsg::Group* parent = nullptr;
+        vsg::StateGroup* stateGroup = nullptr;
+        vsg::dmat4 matrix;
+        size_t scene = 0;
+    };
+
+    std::vector<Occurrence> occurrences;
+    std::function<void(vsg::Node&, vsg::Group*, const vsg::dmat4&, size_t)> collect = [&](vsg::Node& node, vsg::Group* parent, const vsg::dmat4& matrix, size_t scene)
+    {
+        if (auto stateGroup = batchableStateGroup(node))
+        {
+            if (parent) occurrences.push_back(Occurrence{parent, stateGroup, matrix, scene});
+            else markDynamic(node);
+        }
+        else if (node.cast<vsg::StateGroup>())
+        {
+            markDynamic(node);
+        }
+        else if (auto transform = node.cast<vsg::MatrixTransform>())
+        {
+            auto childMatrix = matrix * transform->matrix;
+            for(auto& child : transform->children) collect(*child, transform, childMatrix, scene);
+        }
+        else if (node.cast<vsg::Transform>())
+        {
+            markDynamic(node);
+        }
+        else if (auto group = node.cast<vsg::Group>())
+        {
+            for(auto& child : group->children) collect(*child, group, matrix, scene);
+        }
+        else if (auto cullNode = node.cast<vsg::CullNode>())
+        {
+            if (cullNode->child) collect(*cullNode->child, nullptr, matrix, scene);
+        }
+        else
+        {
+            markDynamic(node);
+        }
+    };
+
+    for(size_t sci = 0; sci < vsg_scenes.size(); ++sci)
+    {
+        if (vsg_scenes[sci]) collect(*vsg_scenes[sci], nullptr, vsg::dmat4(), sci);
+    }
+
+    // group the primitives of each scene by their state and array layout, a primitive is only batched if every path to its parent is static
+    using Edge = std::pair<vsg::Group*, vsg::StateGroup*>;
+    struct BatchGroup
+    {
+        vsg::StateGroup* stateGroup = nullptr;
+        std::vector<GeometryBatcher::Primitive> primitives;
+        std::vector<Edge> edges;
+        std::vector<vsg::ref_ptr<vsg::StateGroup>> batches; // merged primitives
+    };
+
+    std::map<std::tuple<size_t, std::vector<const vsg::StateCommand*>, std::string>, BatchGroup> groups;
+    for(auto& occurrence : occurrences)
+    {
+        if (dynamicNodes.count(occurrence.parent) > 0) continue;
+
+        auto primitive = staticPrimitives[occurrence.stateGroup->children.front()->cast<vsg::Command>()];
+        primitive.matrix = occurrence.matrix;
+
+        auto signature = geometryBatcher.layout(primitive);
+        if (signature.empty()) continue;
+
+        std::vector<const vsg::StateCommand*> stateCommands;
+        for(auto& stateCommand : occurrence.stateGroup->stateCommands) stateCommands.push_back(stateCommand.get());
+
+        auto& group = groups[std::make_tuple(occurrence.scene, stateCommands, signature)];
+        group.stateGroup = occurrence.stateGroup;
+        group.primitives.push_back(primitive);
+        group.edges.emplace_back(occurrence.parent, occurrence.stateGroup);
+    }
+
+    // primitives on their own gain nothing from batching, unless another instance reached through the same parent is batched
+    std::set<Edge> batched;
+    for(auto& [key, group] : groups)
+    {
+        if (group.primitives.size() > 1) batched.insert(group.edges.begin(), group.edges.end());
+    }
+
+    for(auto itr = groups.begin(); itr != groups.end();)
+    {
+        auto& group = itr->second;
+        if (group.primitives.size() == 1 && batched.count(group.edges.front()) == 0) itr = groups.erase(itr);
+        else ++itr;
+    }
+
+    // merge the batches of each group before touching the scene graph, as merge(..) returns null for layouts it can't concatenate
+    std::set<Edge> retained;
+    for(auto& [key, group] : groups)
+    {
+        std::vector<GeometryBatcher::Primitive> batch;
+        size_t batchVertices = 0;
+        bool merged = true;
+        auto addBatch = [&]()
+        {
+            if (batch.empty()) return;
+
+            if (auto vid = geometryBatcher.merge(batch))
+            {
+                auto stateGroup = vsg::StateGroup::create();
+                stateGroup->stateCommands = group.stateGroup->stateCommands;
+                stateGroup->addChild(vid);
+                group.batches.push_back(stateGroup);
+            }
+            else merged = false;
+
+            batch.clear();
+            batchVertices = 0;
+        };
+
+        for(auto& primitive : group.primitives)
+        {
+            size_t primitiveVertices = GeometryBatcher::numVertices(primitive);
+            if (batchVertices + primitiveVertices > geometryBatcher.maxBatchVertices) addBatch();
+
+            batch.push_back(primitive);
+            batchVertices += primitiveVertices;
+        }
+        addBatch();
+
+        if (!merged) retained.insert(group.edges.begin(), group.edges.end());
+    }
+
+    // the original of a failed group stays in place, drawing every primitive reached through its edges, so any other group sharing
+    // one of those edges must be dropped too to avoid drawing its primitives twice, repeated until no more groups are dropped
+    for(bool dropped = true; dropped;)
+    {
+        dropped = false;
+        for(auto itr = groups.begin(); itr != groups.end();)
+        {
+            auto& group = itr->second;
+            bool failed = std::any_of(group.edges.begin(), group.edges.end(), [&](const Edge& edge) { return retained.count(edge) > 0; });
+            if (failed)
+            {
+                retained.insert(group.edges.begin(), group.edges.end());
+                itr = groups.erase(itr);
+                dropped = true;
+            }
+            else ++itr;
+        }
+    }
+
+    for(auto& [key, group] : groups)
+    {
+        for(auto& [parent, stateGroup] : group.edges)
+        {
+            auto& children = parent->children;
+            children.erase(std::remove_if(children.begin(), children.end(), [stateGroup = stateGroup](const vsg::ref_ptr<vsg::Node>& child) { return child.get() == stateGroup; }), children.end());
+        }
+    }
+
+    std::vector<vsg::ref_ptr<vsg::Group>> sceneBatches(vsg_scenes.size());
+    size_t numPrimitives = 0;
+    size_t numBatches = 0;
+    for(auto& [key, group] : groups)
+    {
+        auto& batches = sceneBatches[std::get<0>(key)];
+        if (!batches) batches = vsg::Group::create();
+
+        for(auto& stateGroup : group.batches) batches->addChild(stateGroup);
+
+        numPrimitives += group.primitives.size();
+        numBatches += group.batches.size();
+    }
+
+    // add the batches to each scene, within its CullNode when it has one
+    for(size_t sci = 0; sci < vsg_scenes.size(); ++sci)
+    {
+        auto& batches = sceneBatches[sci];
+        if (!batches) continue;
+
+        if (auto cullNode = vsg_scenes[sci].cast<vsg::CullNode>())
+        {
+            batches->children.insert(batches->children.begin(), cullNode->child);
+            cullNode->child = batches;
+        }
+        else
+        {
+            batches->children.insert(batches->children.begin(), vsg_scenes[sci]);
+            vsg_scenes[sci] = batches;
+        }
+    }
+
+    if (report)
+    {
+        CountDraws drawsAfter;
+        for(auto& scene : vsg_scenes) if (scene) scene->accept(drawsAfter);
+
+        vsg::info("gltf::SceneGraphBuilder::batchGeometry() primitives batched = ", numPrimitives, ", batches = ", numBatches, ", draws before = ", drawsBefore.numDraws, ", after = ", drawsAfter.numDraws,
+                  ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_point).count(), "ms");
+    }
+}
+
+void gltf::SceneGraphBuilder::simplifySceneGraph(bool report)
+{
+    auto start_point = vsg::clock::now();
+
+    struct CountNodes : public vsg::ConstVisitor
+    {
+        size_t numNodes = 0;
+
+        void apply(const vsg::Node& node) override
+        {
+            ++numNodes;
+            node.traverse(*this);
+        }
+    };
+
+    CountNodes nodesBefore;
+    if (report)
+    {
+        for(auto& scene : vsg_scenes) if (scene) scene->accept(nodesBefore);
+    }
+
+    // nodes with more than one parent, or holding a name or extras, are kept as they are
+    std::map<const vsg::Node*, uint32_t> references;
+    for(auto& scene : vsg_scenes) if (scene) countReferences(*scene, references);
+
+    auto removable = [&](const vsg::Node& node, const std::type_info& type)
+    {
+        return typeid(node) == type && references[&node] <= 1 && !node.getAuxiliary();
+    };
+
+    size_t numGroupsCollapsed = 0;
+    size_t numStateGroupsMerged = 0;
+
+    std::set<const vsg::Node*> visited;
+    std::function<vsg::ref_ptr<vsg::Node>(vsg::ref_ptr<vsg::Node>)> simplify = [&](vsg::ref_ptr<vsg::Node> node) -> vsg::ref_ptr<vsg::Node>
+    {
+        if (!visited.insert(node.get()).second) return node;
+
+        if (auto group = node.cast<vsg::Group>())
+        {
+            // simplify the children, moving the children of plain groups up into this group and merging state groups with the same state
+            decltype(group->children) children;
+            std::map<std::vector<const vsg::StateCommand*>, vsg::StateGroup*> stateGroups;
+
+            auto addChild = [&](vsg::ref_ptr<vsg::Node> child)
+            {
+                if (auto stateGroup = child.cast<vsg::StateGroup>(); stateGroup && removable(*stateGroup, typeid(vsg::StateGroup)))
+                {
+                    std::vector<const vsg::StateCommand*> state;
+                    for(auto& stateCommand : stateGroup->stateCommands) state.push_back(stateCommand.get());
+
+                    auto [itr, inserted] = stateGroups.emplace(state, stateGroup.get());
+                    if (!inserted)
+                    {
+                        for(auto& grandchild : stateGroup->children) itr->second->addChild(grandchild);
+                        ++numStateGroupsMerged;
+                        return;
+                    }
+                }
+                children.push_back(child);
+            };
+
+            for(auto& child : group->children)
+            {
+                auto simplified = simplify(child);
+                if (!simplified) continue;
+
+                if (simplified->cast<vsg::Group>() && removable(*simplified, typeid(vsg::Group)))
+                {
+                    for(auto& grandchild : simplified->cast<vsg::Group>()->children) addChild(grandchild);
+                    ++numGroupsCollapsed;
+                }
+                else
+                {
+                    addChild(simplified);
+                }
+            }
+
+            group->children = children;
+
+            if (removable(*group, typeid(vsg::Group)) || removable(*group, typeid(vsg::StateGroup)))
+            {
+                if (group->children.empty())
+                {
+                    ++numGroupsCollapsed;
+                    return {};
+                }
+
+                if (group->children.size() == 1 && typeid(*group) == typeid(vsg::Group))
+                {
+                    ++numGroupsCollapsed;
+                    return group->children.front();
+                }
+            }
+        }
+        else if (auto cullNode = node.cast<vsg::CullNode>())
+        {
+            if (cullNode->child)
+            {
+                if (auto child = simplify(cullNode->child)) cullNode->child = child;
+            }
+        }
+        else if (auto depthSorted = node.cast<vsg::DepthSorted>())
+        {
+            if (depthSorted->child)
+            {
+                if (auto child = simplify(depthSorted->child)) depthSorted->child = child;
+            }
+        }
+
+        return node;
+    };
+
+    for(auto& scene : vsg_scenes)
+    {
+        if (!scene) continue;
+        if (auto simplified = simplify(scene)) scene = simplified;
+    }
+
+    if (report)
+    {
+        CountNodes nodesAfter;
+        for(auto& scene : vsg_scenes) if (scene) scene->accept(nodesAfter);
+
+        vsg::info("gltf::SceneGraphBuilder::simplifySceneGraph() groups removed = ", numGroupsCollapsed, ", state groups merged = ", numStateGroupsMerged,
+                  ", nodes before = ", nodesBefore.numNodes, ", after = ", nodesAfter.numNodes,
+                  ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_point).count(), "ms");
+    }
+}
+
+void gltf::SceneGraphBuilder::sortState(bool report)
+{
+    auto start_point = vsg::clock::now();
+
+    // rank the state commands and vertex arrays by first occurrence so the order is deterministic
+    std::map<const vsg::Object*, uint32_t> ranks;
+    auto rank = [&](const vsg::Object* object) { return ranks.emplace(object, static_cast<uint32_t>(ranks.size())).first->second; };
+
+    // state groups are ordered by the state commands in each slot, with the pipeline in slot 0 first, then by the vertex arrays of their draw
+    using SortKey = std::vector<std::pair<uint32_t, uint32_t>>;
+    auto sortKey = [&](const vsg::StateGroup& stateGroup)
+    {
+        SortKey key;
+        for(auto& stateCommand : stateGroup.stateCommands) key.emplace_back(stateCommand->slot, rank(stateCommand.get()));
+        std::stable_sort(key.begin(), key.end(), [](auto& lhs, auto& rhs) { return lhs.first < rhs.first; });
+
+        if (stateGroup.children.size() == 1)
+        {
+            const vsg::BufferInfoList* arrays = nullptr;
+            if (auto vid = stateGroup.children.front()->cast<vsg::VertexIndexDraw>()) arrays = &vid->arrays;
+            else if (auto vd = stateGroup.children.front()->cast<vsg::VertexDraw>()) arrays = &vd->arrays;
+
+            if (arrays && !arrays->empty() && arrays->front()) key.emplace_back(std::numeric_limits<uint32_t>::max(), rank(arrays->front()->data.get()));
+        }
+        return key;
+    };
+
+    // state is only moved out of state groups with a single parent
+    std::map<const vsg::Node*, uint32_t> references;
+    for(auto& scene : vsg_scenes) if (scene) countReferences(*scene, references);
+
+    size_t numGroupsSorted = 0;
+    size_t numStateCommandsHoisted = 0;
+
+    std::set<const vsg::Node*> visited;
+    std::function<vsg::ref_ptr<vsg::Node>(vsg::ref_ptr<vsg::Node>)> sort = [&](vsg::ref_ptr<vsg::Node> node) -> vsg::ref_ptr<vsg::Node>
+    {
+        if (!visited.insert(node.get()).second) return node;
+
+        if (auto cullNode = node.cast<vsg::CullNode>())
+        {
+            if (cullNode->child) cullNode->child = sort(cullNode->child);
+            return node;
+        }
+
+        auto group = node.cast<vsg::Group>();
+        if (!group) return node;
+
+        for(auto& child : group->children) child = sort(child);
+
+        // reorder the state group children in place, leaving other children such as depth sorted and transformed subgraphs where they are
+        std::vector<size_t> positions;
+        std::vector<std::pair<SortKey, vsg::ref_ptr<vsg::Node>>> stateGroups;
+        for(size_t i = 0; i < group->children.size(); ++i)
+        {
+            if (auto stateGroup = group->children[i].cast<vsg::StateGroup>())
+            {
+                positions.push_back(i);
+                stateGroups.emplace_back(sortKey(*stateGroup), stateGroup);
+            }
+        }
+
+        if (stateGroups.size() > 1)
+        {
+            std::stable_sort(stateGroups.begin(), stateGroups.end(), [](auto& lhs, auto& rhs) { return lhs.first < rhs.first; });
+
+            bool reordered = false;
+            for(size_t i = 0; i < positions.size(); ++i)
+            {
+                auto& child = group->children[positions[i]];
+                if (child != stateGroups[i].second) reordered = true;
+                child = stateGroups[i].second;
+            }
+            if (reordered) ++numGroupsSorted;
+        }
+
+        // move the state commands shared by all the children up into this group, replacing a plain group by a StateGroup
+        bool isStateGroup = typeid(*group) == typeid(vsg::StateGroup);
+        if (group->children.size() < 2 || stateGroups.size() != group->children.size() || references[group.get()] > 1) return node;
+        if (!isStateGroup && typeid(*group) != typeid(vsg::Group)) return node;
+
+        std::set<uint32_t> parentSlots;
+        if (isStateGroup)
+        {
+            for(auto& stateCommand : group.cast<vsg::StateGroup>()->stateCommands) parentSlots.insert(stateCommand->slot);
+        }
+
+        vsg::StateCommands common;
+        for(auto& stateCommand : stateGroups.front().second.cast<vsg::StateGroup>()->stateCommands)
+        {
+            if (parentSlots.count(stateCommand->slot) > 0) continue;
+
+            bool shared = true;
+            for(auto& [key, child] : stateGroups)
+            {
+                auto& stateCommands = child.cast<vsg::StateGroup>()->stateCommands;
+                if (typeid(*child) != typeid(vsg::StateGroup) || references[child.get()] > 1 ||
+                    std::find(stateCommands.begin(), stateCommands.end(), stateCommand) == stateCommands.end())
+                {
+                    shared = false;
+                    break;
+                }
+            }
+            if (shared) common.push_back(stateCommand);
+        }
+
+        if (common.empty()) return node;
+
+        for(auto& [key, child] : stateGroups)
+        {
+            auto& stateCommands = child.cast<vsg::StateGroup>()->stateCommands;
+            stateCommands.erase(std::remove_if(stateCommands.begin(), stateCommands.end(), [&](auto& stateCommand) { return std::find(common.begin(), common.end(), stateCommand) != common.end(); }), stateCommands.end());
+        }
+        numStateCommandsHoisted += common.size();
+
+        if (isStateGroup)
+        {
+            auto stateGroup = group.cast<vsg::StateGroup>();
+            stateGroup->stateCommands.insert(stateGroup->stateCommands.end(), common.begin(), common.end());
+            return node;
+        }
+
+        auto stateGroup = vsg::StateGroup::create();
+        stateGroup->stateCommands = common;
+        stateGroup->children = group->children;
+        if (auto auxiliary = group->getAuxiliary()) stateGroup->getOrCreateAuxiliary()->userObjects = auxiliary->userObjects;
+        return stateGroup;
+    };
+
+    for(auto& scene : vsg_scenes)
+    {
+        if (scene) scene = sort(scene);
+    }
+
+    if (report)
+    {
+        vsg::info("gltf::SceneGraphBuilder::sortState() groups sorted = ", numGroupsSorted, ", state commands hoisted = ", numStateCommandsHoisted,
+                  ", time = ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - start_point).count(), "ms");
+    }
+}
+
+size_t gltf::SceneGraphBuilder::releaseBuffers(gltf::glTF& root, vsg::Object& scene, bool report)
+{
+    // observe the buffers so the ones actually freed can be found once the references are dropped, sizes are recorded now as they can't be read after
+    std::map<const vsg::Data*, std::pair<vsg::observer_ptr<vsg::Data>, size_t>> sourceBuffers;
+    auto observe = [&](const vsg::ref_ptr<vsg::Data>& data) {
+        if (data) sourceBuffers[data.get()] = {data, data->dataSize()};
+    };
+    for(auto& vsg_buffer : vsg_buffers) observe(vsg_buffer);
+    for(auto& buffer : root.buffers.values)
+    {
+        if (buffer) observe(buffer->data);
+    }
+
+    size_t sourceSize = 0;
+    for(auto& [ptr, observed] : sourceBuffers) sourceSize += observed.second;
+
+    ReplaceBufferViews replaceBufferViews;
+    scene.accept(replaceBufferViews);
+    replaceBufferViews.compactArrays.copySpans();
+    replaceBufferViews.collecting = false;
+    scene.accept(replaceBufferViews);
+
+    // drop the references to the original buffers and the views into them
+    vsg_accessors.clear();
+    vsg_bufferViews.clear();
+    vsg_images.clear();
+    vsg_buffers.clear();
+
+    for(auto& buffer : root.buffers.values)
+    {
+        if (buffer) buffer->data = {};
+    }
+    root.streamedData.clear();
+
+    // buffers still referenced, by arrays that couldn't be compacted or by other owners such as a gltf::ResourceCache, aren't reclaimed
+    size_t releasedSize = 0;
+    size_t numStillReferenced = 0;
+    for(auto& [ptr, observed] : sourceBuffers)
+    {
+        if (observed.first.ref_ptr()) ++numStillReferenced;
+        else releasedSize += observed.second;
+    }
+
+    auto& compactArrays = replaceBufferViews.compactArrays;
+    size_t reclaimed = (releasedSize > compactArrays.compactedSize) ? (releasedSize - compactArrays.compactedSize) : 0;
+
+    if (report)
+    {
+        vsg::info("gltf::SceneGraphBuilder::releaseBuffers() buffers = ", sourceSize, " bytes, compacted arrays = ", compactArrays.copies.size(), ", ", compactArrays.compactedSize, " bytes, reclaimed = ", reclaimed, " bytes");
+        if (compactArrays.numRetained > 0) vsg::info("    ", compactArrays.numRetained, " arrays of unsupported types still reference the original buffers.");
+        if (numStillReferenced > 0) vsg::info("    ", numStillReferenced, " of ", sourceBuffers.size(), " buffers are still referenced so weren't released.");
+    }
+
+    return reclaimed;
+}
+
+vsg::ref_ptr<vsg::Data> gltf::createCompatibleArray(vsg::Data& data, uint32_t numElements)
+{
+    CreateCompatibleArray createArray;
+    createArray.numElements = numElements;
+    data.accept(createArray);
+    return createArray.result;
+}
+
+vsg::ref_ptr<vsg::Data> gltf::createArrayView(vsg::Data& data, vsg::ref_ptr<vsg::Data> storage, uint32_t offset, uint32_t stride, uint32_t numElements)
+{
+    CreateCompatibleArray createArray;
+    createArray.numElements = numElements;
+    createArray.storage = storage;
+    createArray.offset = offset;
+    createArray.stride = stride;
+    data.accept(createArray);
+    return createArray.result;
+}
+
+void gltf::copyValues(const vsg::Data& src, size_t srcIndex, vsg::Data& dest, size_t destIndex, size_t count)
+{
+    size_t valueSize = src.valueSize();
+    for(size_t i = 0; i < count; ++i)
+    {
+        std::memcpy(dest.dataPointer(destIndex + i), src.dataPointer(srcIndex + i), valueSize);
     }
+    dest.dirty();
 }
 
@@ -0,0 +1,236 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "gltf.h"
+
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#    include <intrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define GLTF_STRUCTURAL_INDEX_SSE2 1
+#endif
+
+namespace
+{
+    struct BlockMasks
+    {
+        uint64_t backslash = 0;
+        uint64_t quote = 0;
+        uint64_t op = 0;
+    };
+
+#if defined(GLTF_STRUCTURAL_INDEX_SSE2)
+    inline uint64_t movemask(__m128i value)
+    {
+        return static_cast<uint32_t>(_mm_movemask_epi8(value));
+    }
+
+    inline BlockMasks classify(const char* ptr)
+    {
+        const __m128i backslash = _mm_set1_epi8('\\');
+        const __m128i quote = _mm_set1_epi8('"');
+        const __m128i open_brace = _mm_set1_epi8('{');
+        const __m128i close_brace = _mm_set1_epi8('}');
+        const __m128i colon = _mm_set1_epi8(':');
+        const __m128i comma = _mm_set1_epi8(',');
+        const __m128i lower_case = _mm_set1_epi8(0x20);
+
+        BlockMasks masks;
+        for (int i = 0; i < 4; ++i)
+        {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + i * 16));
+
+            // setting bit 0x20 maps '[' and ']' onto '{' and '}', leaving ':' and ',' unchanged
+            __m128i folded = _mm_or_si128(chunk, lower_case);
+            __m128i braces = _mm_or_si128(_mm_cmpeq_epi8(folded, open_brace), _mm_cmpeq_epi8(folded, close_brace));
+            __m128i separators = _mm_or_si128(_mm_cmpeq_epi8(chunk, colon), _mm_cmpeq_epi8(chunk, comma));
+
+            int shift = i * 16;
+            masks.backslash |= movemask(_mm_cmpeq_epi8(chunk, backslash)) << shift;
+            masks.quote |= movemask(_mm_cmpeq_epi8(chunk, quote)) << shift;
+            masks.op |= movemask(_mm_or_si128(braces, separators)) << shift;
+        }
+        return masks;
+    }
+#else
+    inline BlockMasks classify(const char* ptr)
+    {
+        BlockMasks masks;
+        for (uint64_t i = 0; i < 64; ++i)
+        {
+            uint64_t bit = uint64_t(1) << i;
+            switch (ptr[i])
+            {
+            case ('\\'): masks.backslash |= bit; break;
+            case ('"'): masks.quote |= bit; break;
+            case ('{'):
+            case ('}'):
+            case ('['):
+            case (']'):
+            case (':'):
+            case (','): masks.op |= bit; break;
+            default: break;
+            }
+        }
+        return masks;
+    }
+#endif
+
+    // bit i of the result is the xor of bits 0..i of the input
+    inline uint64_t prefix_xor(uint64_t bits)
+    {
+        bits ^= bits << 1;
+        bits ^= bits << 2;
+        bits ^= bits << 4;
+        bits ^= bits << 8;
+        bits ^= bits << 16;
+        bits ^= bits << 32;
+        return bits;
+    }
+
+    // characters escaped by a preceding odd length run of backslashes, carrying runs across blocks via prev_escaped
+    inline uint64_t escaped_characters(uint64_t backslash, uint64_t& prev_escaped)
+    {
+        const uint64_t even_bits = 0x5555555555555555ULL;
+
+        backslash &= ~prev_escaped;
+        uint64_t follows_escape = (backslash << 1) | prev_escaped;
+        uint64_t odd_sequence_starts = backslash & ~even_bits & ~follows_escape;
+
+        uint64_t sequences_starting_on_even_bits = odd_sequence_starts + backslash;
+        prev_escaped = (sequences_starting_on_even_bits < odd_sequence_starts) ? 1 : 0;
+
+        uint64_t invert_mask = sequences_starting_on_even_bits << 1;
+        return (even_bits ^ invert_mask) & follows_escape;
+    }
+
+    inline int trailing_zeros(uint64_t bits)
+    {
+#if defined(_MSC_VER) && !defined(__clang__)
+        unsigned long index;
+        _BitScanForward64(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctzll(bits);
+#endif
+    }
+}
+
+using namespace vsgXchange;
+
+const std::string gltf::StructuralIndex::key("gltf::StructuralIndex");
+
+bool gltf::StructuralIndex::simd()
+{
+#if defined(GLTF_STRUCTURAL_INDEX_SSE2)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool gltf::StructuralIndex::build(const std::string& buffer)
+{
+    positions.clear();
+    matching.clear();
+
+    size_t size = buffer.size();
+    if (size >= static_cast<size_t>(invalid_index)) return false;
+
+    // stage 1 : classify 64 bytes at a time, masking out everything within strings, and flatten the structural bits into positions
+    uint64_t prev_escaped = 0;
+    uint64_t prev_in_string = 0;
+    size_t count = 0;
+    char tail[64];
+
+    for (size_t base = 0; base < size; base += 64)
+    {
+        BlockMasks masks;
+        if (base + 64 <= size)
+        {
+            masks = classify(buffer.data() + base);
+        }
+        else
+        {
+            // pad the final partial block with white space
+            std::fill(std::begin(tail), std::end(tail), ' ');
+            std::copy(buffer.begin() + base, buffer.end(), tail);
+            masks = classify(tail);
+        }
+
+        uint64_t quote = masks.quote & ~escaped_characters(masks.backslash, prev_escaped);
+
+        // bits set from each opening quote up to, but not including, its closing quote
+        uint64_t in_string = prefix_xor(quote) ^ prev_in_string;
+        prev_in_string = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+        uint64_t structurals = (masks.op & ~in_string) | (quote & in_string);
+        if (structurals == 0) continue;
+
+        if (count + 64 > positions.size()) positions.resize(std::max(positions.size() * 2, size_t(4096)));
+
+        uint32_t* ptr = positions.data() + count;
+        while (structurals)
+        {
+            *(ptr++) = static_cast<uint32_t>(base + trailing_zeros(structurals));
+            structurals &= structurals - 1;
+        }
+        count = ptr - positions.data();
+    }
+
+    positions.resize(count);
+
+    if (prev_in_string != 0) return false;
+
+    // pair up the brackets
+    matching.assign(count, invalid_index);
+
+    std::vector<uint32_t> stack;
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        char c = buffer[positions[i]];
+        if (c == '{' || c == '[')
+        {
+            stack.push_back(i);
+        }
+        else if (c == '}' || c == ']')
+        {
+            if (stack.empty()) return false;
+
+            // '{' + 2 == '}' and '[' + 2 == ']'
+            if (buffer[positions[stack.back()]] + 2 != c) return false;
+
+            matching[stack.back()] = i;
+            stack.pop_back();
+        }
+    }
+
+    return stack.empty();
+}
+
+uint32_t gltf::StructuralIndex::index(size_t pos) const
+{
+    auto itr = std::lower_bound(positions.begin(), positions.end(), static_cast<uint32_t>(pos));
+    if (itr == positions.end() || *itr != pos) return invalid_index;
+    return static_cast<uint32_t>(itr - positions.begin());
+}
+
+size_t gltf::StructuralIndex::closing(size_t pos) const
+{
+    auto i = index(pos);
+    if (i == invalid_index || i >= matching.size() || matching[i] == invalid_index) return std::string::npos;
+    return positions[matching[i]];
+}
@@ -0,0 +1,186 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "gltf.h"
+
+#include <vsg/nodes/VertexDraw.h>
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define GLTF_TRANSFORM_FLATTENER_SSE2 1
+#endif
+
+using namespace vsgXchange;
+
+namespace
+{
+    bool mirrors(const vsg::dmat4& m)
+    {
+        vsg::dvec3 c0(m[0][0], m[0][1], m[0][2]), c1(m[1][0], m[1][1], m[1][2]), c2(m[2][0], m[2][1], m[2][2]);
+        return vsg::dot(vsg::cross(c0, c1), c2) < 0.0;
+    }
+
+    vsg::BufferInfoList* drawArrays(vsg::Command& draw)
+    {
+        if (auto vid = draw.cast<vsg::VertexIndexDraw>()) return &vid->arrays;
+        if (auto vd = draw.cast<vsg::VertexDraw>()) return &vd->arrays;
+        return nullptr;
+    }
+
+    // baking writes to new tightly packed arrays so the source must be tightly packed to match the pipeline's vertex bindings
+    vsg::vec3Array* packedVec3Array(const vsg::BufferInfoList& arrays, int i)
+    {
+        if (i < 0 || static_cast<size_t>(i) >= arrays.size() || !arrays[i] || !arrays[i]->data) return nullptr;
+
+        auto vec3s = arrays[i]->data.cast<vsg::vec3Array>();
+        return (vec3s && vec3s->properties.stride == sizeof(vsg::vec3)) ? vec3s.get() : nullptr;
+    }
+}
+
+bool gltf::TransformFlattener::bakeable(const GeometryBatcher::Primitive& primitive, const vsg::dmat4& matrix)
+{
+    if (!primitive.draw) return false;
+
+    auto arrays = drawArrays(*primitive.draw);
+    if (!arrays) return false;
+
+    if (!packedVec3Array(*arrays, primitive.positionArray)) return false;
+    if (primitive.normalArray >= 0 && !packedVec3Array(*arrays, primitive.normalArray)) return false;
+
+    // a mirroring matrix reverses the winding of triangles, which is only corrected for indexed triangle lists
+    if (primitive.triangles && mirrors(matrix))
+    {
+        auto vid = primitive.draw->cast<vsg::VertexIndexDraw>();
+        if (!vid || !vid->indices || !vid->indices->data || !createCompatibleArray(*vid->indices->data, 0)) return false;
+    }
+
+    return true;
+}
+
+void gltf::TransformFlattener::bake(const GeometryBatcher::Primitive& primitive, const vsg::dmat4& matrix)
+{
+    auto& bufferInfos = *drawArrays(*primitive.draw);
+
+    vsg::DataList arrays;
+    for(auto& bufferInfo : bufferInfos) arrays.push_back(bufferInfo->data);
+
+    auto positions = packedVec3Array(bufferInfos, primitive.positionArray);
+    auto bakedPositions = createCompatibleArray(*positions, static_cast<uint32_t>(positions->size())).cast<vsg::vec3Array>();
+    transformPositions(matrix, *positions, *bakedPositions);
+    arrays[primitive.positionArray] = bakedPositions;
+
+    if (auto normals = packedVec3Array(bufferInfos, primitive.normalArray))
+    {
+        auto bakedNormals = createCompatibleArray(*normals, static_cast<uint32_t>(normals->size())).cast<vsg::vec3Array>();
+        transformNormals(matrix, *normals, *bakedNormals);
+        arrays[primitive.normalArray] = bakedNormals;
+    }
+
+    if (auto vid = primitive.draw->cast<vsg::VertexIndexDraw>())
+    {
+        if (primitive.triangles && mirrors(matrix))
+        {
+            auto& indices = *vid->indices->data;
+            auto reversed = createCompatibleArray(indices, static_cast<uint32_t>(indices.valueCount()));
+            copyValues(indices, 0, *reversed, 0, indices.valueCount());
+
+            // swap the second and third vertex of each triangle
+            size_t end = std::min(static_cast<size_t>(vid->firstIndex) + vid->indexCount, reversed->valueCount());
+            for(size_t i = vid->firstIndex; i + 2 < end; i += 3)
+            {
+                copyValues(indices, i + 2, *reversed, i + 1, 1);
+                copyValues(indices, i + 1, *reversed, i + 2, 1);
+            }
+
+            vid->assignIndices(reversed);
+        }
+
+        vid->assignArrays(arrays);
+    }
+    else if (auto vd = primitive.draw->cast<vsg::VertexDraw>())
+    {
+        vd->assignArrays(arrays);
+    }
+}
+
+void gltf::TransformFlattener::transformPositions(const vsg::dmat4& m, const vsg::vec3Array& positions, vsg::vec3Array& result)
+{
+    size_t count = std::min(positions.size(), result.size());
+    size_t i = 0;
+
+#if defined(GLTF_TRANSFORM_FLATTENER_SSE2)
+    const __m128 c0 = _mm_setr_ps(static_cast<float>(m[0][0]), static_cast<float>(m[0][1]), static_cast<float>(m[0][2]), 0.0f);
+    const __m128 c1 = _mm_setr_ps(static_cast<float>(m[1][0]), static_cast<float>(m[1][1]), static_cast<float>(m[1][2]), 0.0f);
+    const __m128 c2 = _mm_setr_ps(static_cast<float>(m[2][0]), static_cast<float>(m[2][1]), static_cast<float>(m[2][2]), 0.0f);
+    const __m128 c3 = _mm_setr_ps(static_cast<float>(m[3][0]), static_cast<float>(m[3][1]), static_cast<float>(m[3][2]), 0.0f);
+
+    // each result is stored as 4 floats with the 4th overwritten by the next vertex, so the last vertex is left to the scalar loop
+    for(; i + 1 < count; ++i)
+    {
+        const vsg::vec3& p = positions[i];
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(p.x)), _mm_mul_ps(c1, _mm_set1_ps(p.y))),
+                              _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(p.z)), c3));
+        _mm_storeu_ps(&result[i].x, r);
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+        result[i] = vsg::vec3(m * vsg::dvec3(positions[i]));
+    }
+
+    result.dirty();
+}
+
+void gltf::TransformFlattener::transformNormals(const vsg::dmat4& m, const vsg::vec3Array& normals, vsg::vec3Array& result)
+{
+    // normals are transformed by the inverse transpose of the matrix
+    auto inv = vsg::inverse(m);
+
+    size_t count = std::min(normals.size(), result.size());
+    size_t i = 0;
+
+#if defined(GLTF_TRANSFORM_FLATTENER_SSE2)
+    const __m128 c0 = _mm_setr_ps(static_cast<float>(inv[0][0]), static_cast<float>(inv[1][0]), static_cast<float>(inv[2][0]), 0.0f);
+    const __m128 c1 = _mm_setr_ps(static_cast<float>(inv[0][1]), static_cast<float>(inv[1][1]), static_cast<float>(inv[2][1]), 0.0f);
+    const __m128 c2 = _mm_setr_ps(static_cast<float>(inv[0][2]), static_cast<float>(inv[1][2]), static_cast<float>(inv[2][2]), 0.0f);
+
+    for(; i + 1 < count; ++i)
+    {
+        const vsg::vec3& n = normals[i];
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(n.x)), _mm_mul_ps(c1, _mm_set1_ps(n.y))), _mm_mul_ps(c2, _mm_set1_ps(n.z)));
+
+        // length squared summed into every lane
+        __m128 sq = _mm_mul_ps(r, r);
+        __m128 length2 = _mm_add_ps(_mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(0, 0, 0, 1))), _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(0, 0, 0, 2)));
+        length2 = _mm_shuffle_ps(length2, length2, _MM_SHUFFLE(0, 0, 0, 0));
+        if (_mm_cvtss_f32(length2) > 0.0f) r = _mm_div_ps(r, _mm_sqrt_ps(length2));
+
+        _mm_storeu_ps(&result[i].x, r);
+    }
+#endif
+
+    for(; i < count; ++i)
+    {
+        vsg::dvec3 n(normals[i]);
+        vsg::dvec3 r(inv[0][0] * n.x + inv[0][1] * n.y + inv[0][2] * n.z,
+                     inv[1][0] * n.x + inv[1][1] * n.y + inv[1][2] * n.z,
+                     inv[2][0] * n.x + inv[2][1] * n.y + inv[2][2] * n.z);
+        double length = vsg::length(r);
+        result[i] = vsg::vec3(length > 0.0 ? r / length : r);
+    }
+
+    result.dirty();
+}
@@ -0,0 +1,288 @@
+/* <editor-fold desc="MIT License">
+
+Copyright(c) 2025 Robert Osfield
+
+Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation files (the "Software"), to deal in the Software without restriction, including without limitation the rights to use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, and to permit persons to whom the Software is furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+</editor-fold> */
+
+#include "gltf.h"
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+using namespace vsgXchange;
+
+namespace
+{
+    constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
+    inline uint64_t mix(uint64_t h)
+    {
+        // MurmurHash3 64 bit finalizer
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h;
+    }
+
+    inline uint64_t hashBytes(const uint8_t* ptr, size_t size, uint64_t h)
+    {
+        for(; size >= 8; ptr += 8, size -= 8)
+        {
+            uint64_t word;
+            std::memcpy(&word, ptr, 8);
+            h = mix(h ^ word) + 0x9e3779b97f4a7c15ULL;
+        }
+
+        if (size > 0)
+        {
+            uint64_t word = 0;
+            std::memcpy(&word, ptr, size);
+            h = mix(h ^ word ^ (static_cast<uint64_t>(size) << 56)) + 0x9e3779b97f4a7c15ULL;
+        }
+
+        return h;
+    }
+
+    // create uint16 or uint32 indices, from remap if not null otherwise sequential
+    vsg::ref_ptr<vsg::Data> createIndices(size_t count, uint32_t numVertices, const uint32_t* remap, vsg::ref_ptr<vsg::OperationThreads> operationThreads, size_t chunkSize)
+    {
+        auto fill = [&](auto ptr)
+        {
+            using T = std::remove_pointer_t<decltype(ptr)>;
+            gltf::parallel_for(operationThreads, (count + chunkSize - 1) / chunkSize, [&](size_t c)
+            {
+                size_t end = std::min(count, (c + 1) * chunkSize);
+                for(size_t i = c * chunkSize; i < end; ++i) ptr[i] = static_cast<T>(remap ? remap[i] : i);
+            });
+        };
+
+        // 0xffff is left free as it's the primitive restart value for uint16 indices
+        if (numVertices < 0xffff)
+        {
+            auto indices = vsg::ushortArray::create(static_cast<uint32_t>(count));
+            fill(indices->data());
+            return indices;
+        }
+        else
+        {
+            auto indices = vsg::uintArray::create(static_cast<uint32_t>(count));
+            fill(indices->data());
+            return indices;
+        }
+    }
+}
+
+bool gltf::VertexWelder::weldable(const vsg::DataList& arrays, uint32_t numVertices)
+{
+    if (numVertices == 0) return false;
+
+    return std::any_of(arrays.begin(), arrays.end(), [numVertices](const vsg::ref_ptr<vsg::Data>& data) { return data && data->valueCount() == numVertices; });
+}
+
+gltf::VertexWelder::Result gltf::VertexWelder::weld(const vsg::DataList& arrays, uint32_t numVertices, vsg::ref_ptr<vsg::OperationThreads> operationThreads) const
+{
+    Result result;
+    if (!weldable(arrays, numVertices)) return result;
+
+    if (numVertices < minParallelVertices) operationThreads = {};
+
+    size_t chunkSize = std::max(verticesPerChunk, 1u);
+
+    // the arrays with a value per vertex are the attributes compared when welding
+    std::vector<vsg::Data*> attributes;
+    for(auto& data : arrays)
+    {
+        if (data && data->valueCount() == numVertices)
+        {
+            if (!createCompatibleArray(*data, 0))
+            {
+                // unsupported type so leave the arrays unwelded, using sequential indices
+                result.arrays = arrays;
+                result.numVertices = numVertices;
+                result.indices = createIndices(numVertices, numVertices, nullptr, operationThreads, chunkSize);
+                return result;
+            }
+            attributes.push_back(data.get());
+        }
+    }
+
+    if (attributes.empty()) return result;
+
+    size_t numChunks = (numVertices + chunkSize - 1) / chunkSize;
+    auto chunkRange = [&](size_t c)
+    {
+        return std::make_pair(c * chunkSize, std::min(static_cast<size_t>(numVertices), (c + 1) * chunkSize));
+    };
+
+    // hash the tuple of attributes of each vertex
+    std::vector<uint64_t> hashes(numVertices);
+    gltf::parallel_for(operationThreads, numChunks, [&](size_t c)
+    {
+        auto [begin, end] = chunkRange(c);
+        for(size_t v = begin; v < end; ++v)
+        {
+            uint64_t h = 0;
+            for(auto attribute : attributes)
+            {
+                h = hashBytes(static_cast<const uint8_t*>(attribute->dataPointer(v)), attribute->valueSize(), h);
+            }
+            hashes[v] = h;
+        }
+    });
+
+    // partition the vertices into buckets by the top bits of their hash, keeping them in ascending order within each bucket
+    uint32_t bucketBits = 0;
+    if (operationThreads)
+    {
+        while ((2u << bucketBits) <= numBuckets && bucketBits < 16) ++bucketBits;
+    }
+    size_t bucketCount = size_t(1) << bucketBits;
+    auto bucket = [&](uint64_t h) { return bucketBits > 0 ? static_cast<size_t>(h >> (64 - bucketBits)) : 0; };
+
+    std::vector<uint32_t> offsets(numChunks * bucketCount, 0);
+    gltf::parallel_for(operationThreads, numChunks, [&](size_t c)
+    {
+        auto [begin, end] = chunkRange(c);
+        uint32_t* counts = &offsets[c * bucketCount];
+        for(size_t v = begin; v < end; ++v) ++counts[bucket(hashes[v])];
+    });
+
+    std::vector<uint32_t> bucketStart(bucketCount + 1, 0);
+    uint32_t position = 0;
+    for(size_t b = 0; b < bucketCount; ++b)
+    {
+        bucketStart[b] = position;
+        for(size_t c = 0; c < numChunks; ++c)
+        {
+            uint32_t count = offsets[c * bucketCount + b];
+            offsets[c * bucketCount + b] = position;
+            position += count;
+        }
+    }
+    bucketStart[bucketCount] = position;
+
+    std::vector<uint32_t> order(numVertices);
+    gltf::parallel_for(operationThreads, numChunks, [&](size_t c)
+    {
+        auto [begin, end] = chunkRange(c);
+        uint32_t* next = &offsets[c * bucketCount];
+        for(size_t v = begin; v < end; ++v) order[next[bucket(hashes[v])]++] = static_cast<uint32_t>(v);
+    });
+
+    // within each bucket find the first occurrence of each unique vertex
+    auto equal = [&](uint32_t lhs, uint32_t rhs)
+    {
+        for(auto attribute : attributes)
+        {
+            if (std::memcmp(attribute->dataPointer(lhs), attribute->dataPointer(rhs), attribute->valueSize()) != 0) return false;
+        }
+        return true;
+    };
+
+    std::vector<uint32_t> representative(numVertices);
+    gltf::parallel_for(operationThreads, bucketCount, [&](size_t b)
+    {
+        size_t size = bucketStart[b + 1] - bucketStart[b];
+        if (size == 0) return;
+
+        size_t tableSize = 16;
+        while (tableSize < size * 2) tableSize *= 2;
+        size_t mask = tableSize - 1;
+
+        std::vector<uint32_t> table(tableSize, invalid_index);
+        for(size_t i = bucketStart[b]; i < bucketStart[b + 1]; ++i)
+        {
+            uint32_t v = order[i];
+            uint64_t h = hashes[v];
+            for(size_t slot = static_cast<size_t>(h) & mask;; slot = (slot + 1) & mask)
+            {
+                uint32_t u = table[slot];
+                if (u == invalid_index)
+                {
+                    table[slot] = v;
+                    representative[v] = v;
+                    break;
+                }
+                if (hashes[u] == h && equal(u, v))
+                {
+                    representative[v] = u;
+                    break;
+                }
+            }
+        }
+    });
+
+    // number the unique vertices in order of first occurrence, representatives always precede the vertices that refer to them
+    std::vector<uint32_t> remap(numVertices);
+    std::vector<uint32_t> uniqueVertices;
+    uniqueVertices.reserve(numVertices);
+    for(uint32_t v = 0; v < numVertices; ++v)
+    {
+        if (representative[v] == v)
+        {
+            remap[v] = static_cast<uint32_t>(uniqueVertices.size());
+            uniqueVertices.push_back(v);
+        }
+        else
+        {
+            remap[v] = remap[representative[v]];
+        }
+    }
+
+    uint32_t numUnique = static_cast<uint32_t>(uniqueVertices.size());
+    size_t numUniqueChunks = (numUnique + chunkSize - 1) / chunkSize;
+
+    for(auto& data : arrays)
+    {
+        if (data && data->valueCount() == numVertices)
+        {
+            // strided views keep their stride as the pipeline's vertex bindings were set up with it
+            uint32_t stride = data->properties.stride;
+            vsg::ref_ptr<vsg::Data> welded;
+            if (stride > data->valueSize())
+            {
+                auto storage = vsg::ubyteArray::create(static_cast<uint32_t>(static_cast<size_t>(numUnique) * stride));
+                welded = createArrayView(*data, storage, 0, stride, numUnique);
+            }
+            else
+            {
+                welded = createCompatibleArray(*data, numUnique);
+            }
+
+            if (!welded || welded->properties.stride != data->properties.stride)
+            {
+                // can't match the bound stride so leave the arrays unwelded, using sequential indices
+                result.arrays = arrays;
+                result.numVertices = numVertices;
+                result.indices = createIndices(numVertices, numVertices, nullptr, operationThreads, chunkSize);
+                return result;
+            }
+
+            gltf::parallel_for(operationThreads, numUniqueChunks, [&](size_t c)
+            {
+                size_t end = std::min(static_cast<size_t>(numUnique), (c + 1) * chunkSize);
+                for(size_t i = c * chunkSize; i < end; ++i) copyValues(*data, uniqueVertices[i], *welded, i, 1);
+            });
+            welded->dirty();
+            result.arrays.push_back(welded);
+        }
+        else
+        {
+            result.arrays.push_back(data);
+        }
+    }
+
+    result.indices = createIndices(numVertices, numUnique, remap.data(), operationThreads, chunkSize);
+    result.numVertices = numUnique;
+
+    return result;
+}
@@ -14,17 +14,55 @@ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLI
 
 #include "gltf.h"
 
+#include <vsg/io/Input.h>
+#include <vsg/io/ObjectFactory.h>
+#include <vsg/io/Output.h>
 #include <vsg/io/Path.h>
 #include <vsg/io/mem_stream.h>
 #include <vsg/io/read.h>
 #include <vsg/io/write.h>
+#include <vsg/maths/transform.h>
 #include <vsg/threading/OperationThreads.h>
 #include <vsg/utils/CommandLine.h>
 
+#include <algorithm>
+#include <charconv>
+#include <cstring>
 #include <fstream>
+#include <list>
 
 using namespace vsgXchange;
 
+namespace
+{
+    // true when only the elements required by glTF::createSummary() are being parsed, see gltf::Summary::key
+    bool structureOnly(vsg::JSONParser& parser)
+    {
+        return parser.getObject(gltf::Summary::key) != nullptr;
+    }
+
+    // skip over the array or object at the parser's position
+    void skip(vsg::JSONParser& parser)
+    {
+        std::string_view json;
+        gltf::read_json(parser, json);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// ExtensionRegistry
+//
+const std::string gltf::ExtensionRegistry::key("gltf::ExtensionRegistry");
+
+uint32_t gltf::ExtensionRegistry::id(const std::string_view& name) const
+{
+    for(size_t i = 0; i < entries.size(); ++i)
+    {
+        if (entries[i].name == name) return static_cast<uint32_t>(i);
+    }
+    return invalid_id;
+}
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //
@@ -33,32 +71,111 @@ using namespace vsgXchange;
 void gltf::Extensions::report()
 {
     vsg::info("    extensions = {");
-    for(auto& [name, ext] : values)
+    for(auto& value : values)
     {
-        vsg::info("    {", name , ", ", ext->className()," }");
+        if (value.schema) vsg::info("    {", value.name , ", ", value.schema->className()," }");
+        else vsg::info("    {", value.name , ", ", value.json.size(), " bytes of JSON }");
     }
     vsg::info("    }");
 }
 
 void gltf::Extensions::read_object(vsg::JSONParser& parser, const std::string_view& property)
 {
-    std::string str_property(property);
-    auto schema = parser.getRefObject<vsg::JSONParser::Schema>(str_property);
-    if (schema)
+    Extension& extension = values.emplace_back();
+    extension.name = property;
+
+    auto registry = parser.getObject<ExtensionRegistry>(ExtensionRegistry::key);
+    if (registry) extension.id = registry->id(property);
+
+    if (extension.id != ExtensionRegistry::invalid_id)
+    {
+        extension.schema = registry->entries[extension.id].create();
+        parser.read_object(*extension.schema);
+        return;
+    }
+
+    vsg::info("gltf::Extensions::read_object() property = ", property);
+
+    // retain the unregistered extension as raw JSON rather than building a JSONtoMetaDataSchema for it
+    gltf::read_json(parser, extension.json);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// LazyExtras
+//
+const std::string gltf::LazyExtras::key("gltf::LazyExtras");
+
+static vsg::RegisterWithObjectFactoryProxy<gltf::LazyExtras> s_Register_LazyExtras;
+
+gltf::LazyExtras::LazyExtras(const std::string_view& in_json)
+{
+    // copy the JSON, dropping the white space outside of strings
+    json.reserve(in_json.size());
+
+    bool inString = false;
+    for(size_t i = 0; i < in_json.size(); ++i)
     {
-        if (auto extension = vsg::clone(schema))
+        char c = in_json[i];
+        if (inString)
         {
-            parser.read_object(*extension);
-            values[str_property] = extension;
-            return;
+            json.push_back(c);
+            if (c == '\\' && (i + 1) < in_json.size()) json.push_back(in_json[++i]);
+            else if (c == '"') inString = false;
+        }
+        else if (c == '"')
+        {
+            json.push_back(c);
+            inString = true;
+        }
+        else if (c != ' ' && c != '\t' && c != '\r' && c != '\n')
+        {
+            json.push_back(c);
         }
     }
 
-    vsg::info("gltf::Extensions::read_object() property = ", property);
+    json.shrink_to_fit();
+}
+
+vsg::ref_ptr<vsg::Object> gltf::LazyExtras::object()
+{
+    std::scoped_lock<std::mutex> lock(_mutex);
+
+    if (!_object && !json.empty() && json.front() == '{')
+    {
+        vsg::JSONParser parser;
+        parser.buffer = json;
+        parser.pos = 0;
+
+        auto schema = Extras::create();
+        parser.read_object(*schema);
+
+        if (schema->object) _object = schema->object;
+        else if (schema->objects) _object = schema->objects;
+    }
+
+    return _object;
+}
 
-    auto extensionAsMetaData = JSONtoMetaDataSchema::create();
-    parser.read_object(*extensionAsMetaData);
-    values[str_property] = extensionAsMetaData;
+void gltf::LazyExtras::read(vsg::Input& input)
+{
+    vsg::Object::read(input);
+
+    input.read("json", json);
+}
+
+void gltf::LazyExtras::write(vsg::Output& output) const
+{
+    vsg::Object::write(output);
+
+    output.write("json", json);
+}
+
+vsg::ref_ptr<vsg::Object> gltf::extras(vsg::Object& object)
+{
+    auto extrasObject = object.getRefObject("extras");
+    if (auto lazyExtras = extrasObject.cast<LazyExtras>()) return lazyExtras->object();
+    return extrasObject;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -67,15 +184,27 @@ void gltf::Extensions::read_object(vsg::JSONParser& parser, const std::string_vi
 //
 void gltf::ExtensionsExtras::read_object(vsg::JSONParser& parser, const std::string_view& property)
 {
-    if (property=="extensions")
+    if ((property=="extensions" || property=="extras") && structureOnly(parser))
+    {
+        skip(parser);
+    }
+    else if (property=="extensions")
     {
         if (!extensions) extensions = Extensions::create();
         parser.read_object(*extensions);
     }
     else if (property=="extras")
     {
-        if (!extras) extras = Extras::create();
-        parser.read_object(*extras);
+        if (parser.getObject(LazyExtras::key))
+        {
+            std::string_view json;
+            if (gltf::read_json(parser, json)) lazyExtras = LazyExtras::create(json);
+        }
+        else
+        {
+            if (!extras) extras = Extras::create();
+            parser.read_object(*extras);
+        }
     }
     else parser.warning();
 };
@@ -118,9 +247,9 @@ void gltf::SparseIndices::report()
 
 void gltf::SparseIndices::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="bufferView") input >> bufferView;
-    else if (property=="byteOffset") input >> byteOffset;
-    else if (property=="componentType") input >> componentType;
+    if (property=="bufferView") read_value(parser, input, bufferView);
+    else if (property=="byteOffset") read_value(parser, input, byteOffset);
+    else if (property=="componentType") read_value(parser, input, componentType);
     else parser.warning();
 }
 
@@ -134,8 +263,8 @@ void gltf::SparseValues::report()
 
 void gltf::SparseValues::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="bufferView") input >> bufferView;
-    else if (property=="byteOffset") input >> byteOffset;
+    if (property=="bufferView") read_value(parser, input, bufferView);
+    else if (property=="byteOffset") read_value(parser, input, byteOffset);
     else parser.warning();
 }
 
@@ -151,7 +280,7 @@ void gltf::Sparse::report()
 
 void gltf::Sparse::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="count") input >> count;
+    if (property=="count") read_value(parser, input, count);
     else parser.warning();
 }
 
@@ -188,7 +317,14 @@ void gltf::Accessor::report()
 
 void gltf::Accessor::read_array(vsg::JSONParser& parser, const std::string_view& property)
 {
-    if (property == "min") parser.read_array(min);
+    if (structureOnly(parser))
+    {
+        // only the min/max of POSITION accessors are needed by glTF::createSummary(), so retain the JSON to parse on demand
+        if (property == "min") gltf::read_json(parser, minJSON);
+        else if (property == "max") gltf::read_json(parser, maxJSON);
+        else parser.warning();
+    }
+    else if (property == "min") parser.read_array(min);
     else if (property == "max") parser.read_array(max);
     else parser.warning();
 }
@@ -201,10 +337,10 @@ void gltf::Accessor::read_string(vsg::JSONParser& parser, const std::string_view
 
 void gltf::Accessor::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="bufferView") input >> bufferView;
-    else if (property=="byteOffset") input >> byteOffset;
-    else if (property=="componentType") input >> componentType;
-    else if (property=="count") input >> count;
+    if (property=="bufferView") read_value(parser, input, bufferView);
+    else if (property=="byteOffset") read_value(parser, input, byteOffset);
+    else if (property=="componentType") read_value(parser, input, componentType);
+    else if (property=="count") read_value(parser, input, count);
     else parser.warning();
 }
 
@@ -216,7 +352,11 @@ void gltf::Accessor::read_bool(vsg::JSONParser& parser, const std::string_view&
 
 void gltf::Accessor::read_object(vsg::JSONParser& parser, const std::string_view& property)
 {
-    if (property=="sparse")
+    if (property=="sparse" && structureOnly(parser))
+    {
+        skip(parser);
+    }
+    else if (property=="sparse")
     {
         if (!sparse) sparse = Sparse::create();
         parser.read_object(*sparse);
@@ -264,11 +404,11 @@ void gltf::BufferView::report()
 
 void gltf::BufferView::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="buffer") input >> buffer;
-    else if (property=="byteOffset") input >> byteOffset;
-    else if (property=="byteLength") input >> byteLength;
-    else if (property=="byteStride") input >> byteStride;
-    else if (property=="target") input >> target;
+    if (property=="buffer") read_value(parser, input, buffer);
+    else if (property=="byteOffset") read_value(parser, input, byteOffset);
+    else if (property=="byteLength") read_value(parser, input, byteLength);
+    else if (property=="byteStride") read_value(parser, input, byteStride);
+    else if (property=="target") read_value(parser, input, target);
     else parser.warning();
 }
 
@@ -294,7 +434,7 @@ void gltf::Buffer::read_string(vsg::JSONParser& parser, const std::string_view&
 
 void gltf::Buffer::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="byteLength") input >> byteLength;
+    if (property=="byteLength") read_value(parser, input, byteLength);
     else parser.warning();
 }
 
@@ -322,7 +462,7 @@ void gltf::Image::read_string(vsg::JSONParser& parser, const std::string_view& p
 
 void gltf::Image::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="bufferView") input >> bufferView;
+    if (property=="bufferView") read_value(parser, input, bufferView);
     else parser.warning();
 }
 
@@ -332,8 +472,8 @@ void gltf::Image::read_number(vsg::JSONParser& parser, const std::string_view& p
 //
 void gltf::TextureInfo::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="index") input >> index;
-    else if (property=="texCoord") input >> texCoord;
+    if (property=="index") read_value(parser, input, index);
+    else if (property=="texCoord") read_value(parser, input, texCoord);
     else parser.warning();
 }
 
@@ -352,20 +492,20 @@ void gltf::PbrMetallicRoughness::read_object(vsg::JSONParser& parser, const std:
 
 void gltf::PbrMetallicRoughness::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="metallicFactor") input >> metallicFactor;
-    else if (property=="roughnessFactor") input >> roughnessFactor;
+    if (property=="metallicFactor") read_value(parser, input, metallicFactor);
+    else if (property=="roughnessFactor") read_value(parser, input, roughnessFactor);
     else parser.warning();
 }
 
 void gltf::NormalTextureInfo::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property == "scale") input >> scale;
+    if (property == "scale") read_value(parser, input, scale);
     else TextureInfo::read_number(parser, property, input);
 }
 
 void gltf::OcclusionTextureInfo::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property == "strength") input >> strength;
+    if (property == "strength") read_value(parser, input, strength);
     else TextureInfo::read_number(parser, property, input);
 }
 
@@ -384,13 +524,13 @@ void gltf::KHR_materials_specular::read_object(vsg::JSONParser& parser, const st
 
 void gltf::KHR_materials_specular::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property == "specularFactor") input >> specularFactor;
+    if (property == "specularFactor") read_value(parser, input, specularFactor);
     else parser.warning();
 }
 
 void gltf::KHR_materials_ior::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="ior") input >> ior;
+    if (property=="ior") read_value(parser, input, ior);
     else parser.warning();
 }
 
@@ -438,7 +578,7 @@ void gltf::Material::read_string(vsg::JSONParser& parser, const std::string_view
 
 void gltf::Material::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="alphaCutoff") input >> alphaCutoff;
+    if (property=="alphaCutoff") read_value(parser, input, alphaCutoff);
     else parser.warning();
 }
 
@@ -452,9 +592,9 @@ void gltf::Material::read_bool(vsg::JSONParser& parser, const std::string_view&
 //
 // Mesh
 //
-void gltf::Attributes::read_number(vsg::JSONParser&, const std::string_view& property, std::istream& input)
+void gltf::Attributes::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    input >> values[std::string(property)];
+    read_value(parser, input, values[std::string(property)]);
 }
 
 void gltf::Primitive::report()
@@ -480,15 +620,16 @@ void gltf::Primitive::report()
 
 void gltf::Primitive::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property == "indices") input >> indices;
-    else if (property == "material") input >> material;
-    else if (property == "mode") input >> mode;
+    if (property == "indices") read_value(parser, input, indices);
+    else if (property == "material") read_value(parser, input, material);
+    else if (property == "mode") read_value(parser, input, mode);
     else parser.warning();
 }
 
 void gltf::Primitive::read_array(vsg::JSONParser& parser, const std::string_view& property)
 {
-    if (property=="targets") parser.read_array(targets);
+    if (property=="targets" && structureOnly(parser)) skip(parser);
+    else if (property=="targets") parser.read_array(targets);
     else parser.warning();
 }
 
@@ -510,6 +651,7 @@ void gltf::Mesh::report()
 void gltf::Mesh::read_array(vsg::JSONParser& parser, const std::string_view& property)
 {
     if (property == "primitives") parser.read_array(primitives);
+    else if (property == "weights" && structureOnly(parser)) skip(parser);
     else if (property == "weights") parser.read_array(weights);
     else parser.warning();
 }
@@ -541,15 +683,16 @@ void gltf::Node::read_array(vsg::JSONParser& parser, const std::string_view& pro
     else if (property == "rotation") parser.read_array(rotation);
     else if (property == "scale") parser.read_array(scale);
     else if (property == "translation") parser.read_array(translation);
+    else if (property == "weights" && structureOnly(parser)) skip(parser);
     else if (property == "weights") parser.read_array(weights);
     else parser.warning();
 }
 
 void gltf::Node::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="camera") input >> camera;
-    else if (property=="skin") input >> skin;
-    else if (property=="mesh") input >> mesh;
+    if (property=="camera") read_value(parser, input, camera);
+    else if (property=="skin") read_value(parser, input, skin);
+    else if (property=="mesh") read_value(parser, input, mesh);
     else parser.warning();
 }
 
@@ -570,10 +713,10 @@ void gltf::Sampler::report()
 
 void gltf::Sampler::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="minFilter") input >> minFilter;
-    else if (property=="magFilter") input >> magFilter;
-    else if (property=="wrapS") input >> wrapS;
-    else if (property=="wrapT") input >> wrapT;
+    if (property=="minFilter") read_value(parser, input, minFilter);
+    else if (property=="magFilter") read_value(parser, input, magFilter);
+    else if (property=="wrapS") read_value(parser, input, wrapS);
+    else if (property=="wrapT") read_value(parser, input, wrapT);
     else parser.warning();
 }
 
@@ -610,8 +753,8 @@ void gltf::Texture::report()
 
 void gltf::Texture::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="sampler") input >> sampler;
-    else if (property=="source") input >> source;
+    if (property=="sampler") read_value(parser, input, sampler);
+    else if (property=="source") read_value(parser, input, source);
     else parser.warning();
 }
 
@@ -627,13 +770,13 @@ void gltf::AnimationTarget::read_string(vsg::JSONParser& parser, const std::stri
 
 void gltf::AnimationTarget::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="node") input >> node;
+    if (property=="node") read_value(parser, input, node);
     else parser.warning();
 }
 
 void gltf::AnimationChannel::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="sampler") input >> sampler;
+    if (property=="sampler") read_value(parser, input, sampler);
     else parser.warning();
 }
 
@@ -651,8 +794,8 @@ void gltf::AnimationSampler::read_string(vsg::JSONParser& parser, const std::str
 
 void gltf::AnimationSampler::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& in_input)
 {
-    if (property=="input") in_input >> input;
-    else if (property=="output") in_input >> output;
+    if (property=="input") read_value(parser, in_input, input);
+    else if (property=="output") read_value(parser, in_input, output);
     else parser.warning();
 }
 
@@ -682,10 +825,10 @@ void gltf::Orthographic::report()
 
 void gltf::Orthographic::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="xmag") input >> xmag;
-    else if (property=="ymag") input >> ymag;
-    else if (property=="znear") input >> znear;
-    else if (property=="zfar") input >> zfar;
+    if (property=="xmag") read_value(parser, input, xmag);
+    else if (property=="ymag") read_value(parser, input, ymag);
+    else if (property=="znear") read_value(parser, input, znear);
+    else if (property=="zfar") read_value(parser, input, zfar);
     else parser.warning();
 }
 
@@ -696,10 +839,10 @@ void gltf::Perspective::report()
 
 void gltf::Perspective::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="aspectRatio") input >> aspectRatio;
-    else if (property=="yfov") input >> yfov;
-    else if (property=="znear") input >> znear;
-    else if (property=="zfar") input >> zfar;
+    if (property=="aspectRatio") read_value(parser, input, aspectRatio);
+    else if (property=="yfov") read_value(parser, input, yfov);
+    else if (property=="znear") read_value(parser, input, znear);
+    else if (property=="zfar") read_value(parser, input, zfar);
     else parser.warning();
 }
 
@@ -748,202 +891,957 @@ void gltf::Skins::report()
 
 void gltf::Skins::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
 {
-    if (property=="inverseBindMatrices") input >> inverseBindMatrices;
-    else if (property=="skeleton") input >> skeleton;
+    if (property=="inverseBindMatrices") read_value(parser, input, inverseBindMatrices);
+    else if (property=="skeleton") read_value(parser, input, skeleton);
     else parser.warning();
 }
 
 void gltf::Skins::read_array(vsg::JSONParser& parser, const std::string_view& property)
 {
-    if (property == "joints") parser.read_array(joints);
+    if (property == "joints" && structureOnly(parser)) skip(parser);
+    else if (property == "joints") parser.read_array(joints);
     else parser.warning();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //
-// glTF
+// Arena
 //
-void gltf::glTF::report()
+void* gltf::Arena::allocate(size_t size, size_t alignment)
 {
-    vsg::info("\nglTF {");
-    if (asset) asset->report();
-    accessors.report();
-    bufferViews.report();
-    buffers.report();
-    images.report();
-    materials.report();
-    meshes.report();
-    nodes.report();
-    samplers.report();
-    vsg::info("scene = ", scene);
-    scenes.report();
-    textures.report();
-    animations.report();
-    cameras.report();
-    skins.report();
-    vsg::info("}\n");
+    uintptr_t address = (reinterpret_cast<uintptr_t>(ptr) + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    if (!ptr || address + size > reinterpret_cast<uintptr_t>(end))
+    {
+        // oversized allocations get a block of their own
+        size_t newBlockSize = std::max(blockSize, size + alignment);
+        blocks.emplace_back(new uint8_t[newBlockSize]);
+        ptr = blocks.back().get();
+        end = ptr + newBlockSize;
+        address = (reinterpret_cast<uintptr_t>(ptr) + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    }
+
+    ptr = reinterpret_cast<uint8_t*>(address + size);
+    totalAllocated += size;
+    return reinterpret_cast<void*>(address);
 }
 
-void gltf::glTF::read_array(vsg::JSONParser& parser, const std::string_view& property)
+std::string_view gltf::Arena::copy(const std::string_view& str)
 {
-    if (property == "extensionsUsed") parser.read_array(extensionsUsed);
-    else if (property == "extensionsRequired") parser.read_array(extensionsRequired);
-    else if (property == "accessors") parser.read_array(accessors);
-    else if (property == "animations") parser.read_array(animations);
-    else if (property == "buffers") parser.read_array(buffers);
-    else if (property == "bufferViews") parser.read_array(bufferViews);
-    else if (property == "cameras")  parser.read_array(cameras);
-    else if (property == "materials") parser.read_array(materials);
-    else if (property == "meshes") parser.read_array(meshes);
-    else if (property == "nodes") parser.read_array(nodes);
-    else if (property == "samplers") parser.read_array(samplers);
-    else if (property == "scenes") parser.read_array(scenes);
-    else if (property == "skins") parser.read_array(skins);
-    else if (property == "images") parser.read_array(images);
-    else if (property == "textures") parser.read_array(textures);
-    else parser.warning();
+    if (str.empty()) return {};
+
+    auto dest = static_cast<char*>(allocate(str.size(), 1));
+    std::copy(str.begin(), str.end(), dest);
+    return std::string_view(dest, str.size());
 }
 
-void gltf::glTF::read_object(vsg::JSONParser& parser, const std::string_view& property)
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// CompactDocument
+//
+void gltf::CompactDocument::Accessors::push_back()
 {
-    if (property == "asset")
-    {
-        asset = gltf::Asset::create();
-        parser.read_object(*asset);
-    }
-    else ExtensionsExtras::read_object(parser, property);
+    bufferView.emplace_back();
+    byteOffset.push_back(0);
+    componentType.push_back(0);
+    normalized.push_back(0);
+    count.push_back(0);
+    type.push_back(invalid_id);
+    min.emplace_back();
+    max.emplace_back();
+    name.push_back(invalid_id);
+    extensionsExtras.push_back(invalid_id);
 }
 
-void gltf::glTF::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
+void gltf::CompactDocument::BufferViews::push_back()
 {
-    if (property == "scene") input >> scene;
-    else parser.warning();
+    buffer.emplace_back();
+    byteOffset.push_back(0);
+    byteLength.push_back(0);
+    byteStride.push_back(0);
+    target.push_back(0);
+    name.push_back(invalid_id);
+    extensionsExtras.push_back(invalid_id);
 }
 
-void gltf::glTF::resolveURIs(vsg::ref_ptr<const vsg::Options> options)
+void gltf::CompactDocument::Nodes::push_back()
 {
-    vsg::ref_ptr<vsg::OperationThreads> operationThreads;
-    if (options) operationThreads = options->operationThreads;
+    camera.emplace_back();
+    skin.emplace_back();
+    mesh.emplace_back();
+    children.emplace_back();
+    matrix.emplace_back();
+    rotation.emplace_back();
+    scale.emplace_back();
+    translation.emplace_back();
+    weights.emplace_back();
+    name.push_back(invalid_id);
+    extensionsExtras.push_back(invalid_id);
+}
 
-    auto dataURI = [](const std::string_view& uri, std::string_view& mimeType, std::string_view& encoding, std::string_view& value) -> bool
-    {
-        if (uri.size() <= 5) return false;
-        if (uri.compare(0, 5, "data:") != 0) return false;
+uint32_t gltf::CompactDocument::intern(const std::string_view& str)
+{
+    if (auto itr = stringLookup.find(str); itr != stringLookup.end()) return itr->second;
 
+    auto id = static_cast<uint32_t>(strings.size());
+    auto copy = arena.copy(str);
+    strings.push_back(copy);
+    stringLookup[copy] = id;
+    return id;
+}
 
-        auto semicolon = uri.find(';', 6);
-        auto comma = uri.find(',', semicolon+1);
+void gltf::CompactDocument::report()
+{
+    vsg::info("CompactDocument { ");
+    vsg::info("    accessors: ", accessors.size());
+    vsg::info("    bufferViews: ", bufferViews.size());
+    vsg::info("    nodes: ", nodes.size());
+    vsg::info("    strings: ", strings.size(), ", arena allocated: ", arena.allocated());
+    vsg::info("    doubles: ", doubles.size(), ", ids: ", ids.size(), ", extensionsExtras: ", extensionsExtras.size());
+    vsg::info("} ");
+}
 
-        mimeType = std::string_view(&uri[5], semicolon-5);
-        encoding = std::string_view(&uri[semicolon+1], comma - semicolon-1);
-        value = std::string_view(&uri[comma+1], uri.size() - comma -1);
+gltf::CompactDocument::Range gltf::CompactDocument::read_doubles(vsg::JSONParser& parser)
+{
+    doublesSchema.values.clear();
+    parser.read_array(doublesSchema);
 
-        return true;
-    };
+    Range range{static_cast<uint32_t>(doubles.size()), static_cast<uint32_t>(doublesSchema.values.size())};
+    doubles.insert(doubles.end(), doublesSchema.values.begin(), doublesSchema.values.end());
+    return range;
+}
 
-    auto mimeTypeToExtension = [](const std::string_view& mimeType) -> vsg::Path
-    {
-        if (mimeType=="image/png") return ".png";
-        else if (mimeType=="image/jpeg") return ".jpeg";
-        else if (mimeType=="image/bmp") return ".bmp";
-        else if (mimeType=="image/gif") return ".gif";
-        else if (mimeType=="image/ktx") return ".ktx";
-        return "";
-    };
+gltf::CompactDocument::Range gltf::CompactDocument::read_ids(vsg::JSONParser& parser)
+{
+    idsSchema.values.clear();
+    parser.read_array(idsSchema);
 
-    struct OperationWithLatch : public vsg::Inherit<vsg::Operation, OperationWithLatch>
-    {
-        vsg::ref_ptr<vsg::Latch> latch;
+    Range range{static_cast<uint32_t>(ids.size()), static_cast<uint32_t>(idsSchema.values.size())};
+    ids.insert(ids.end(), idsSchema.values.begin(), idsSchema.values.end());
+    return range;
+}
 
-        OperationWithLatch(vsg::ref_ptr<vsg::Latch> l) : latch(l) {}
-    };
+uint32_t gltf::CompactDocument::read_string(vsg::JSONParser& parser)
+{
+    parser.read_string(str);
+    return intern(str);
+}
 
-    struct ReadFileOperation : public vsg::Inherit<OperationWithLatch, ReadFileOperation>
+void gltf::CompactDocument::read_extensionsExtras(vsg::JSONParser& parser, const std::string_view& property, uint32_t& index)
+{
+    if (property != "extensions" && property != "extras")
     {
-        std::string_view filename;
-        vsg::ref_ptr<const vsg::Options> options;
-        vsg::ref_ptr<vsg::Data>& data;
+        parser.warning();
+        return;
+    }
 
-        ReadFileOperation(const std::string_view& f, vsg::ref_ptr<const vsg::Options> o, vsg::ref_ptr<vsg::Data>& d, vsg::ref_ptr<vsg::Latch> l = {}) :
-            Inherit(l),
-            filename(f),
-            options(o),
-            data(d) {}
+    if (index == invalid_id)
+    {
+        index = static_cast<uint32_t>(extensionsExtras.size());
+        extensionsExtras.push_back(NameExtensionsExtras::create());
+    }
+    extensionsExtras[index]->read_object(parser, property);
+}
 
-        void run() override
-        {
-            data = vsg::read_cast<vsg::Data>(std::string(filename), options);
+void gltf::CompactDocument::AccessorsSchema::read_object(vsg::JSONParser& parser)
+{
+    document->accessors.push_back();
+    parser.read_object(*this);
+}
 
-            if (latch) latch->count_down();
-        }
-    };
+void gltf::CompactDocument::AccessorsSchema::read_array(vsg::JSONParser& parser, const std::string_view& property)
+{
+    auto& accessors = document->accessors;
+    if (property == "min") accessors.min.back() = document->read_doubles(parser);
+    else if (property == "max") accessors.max.back() = document->read_doubles(parser);
+    else parser.warning();
+}
 
-    struct ReadBufferOperation : public vsg::Inherit<OperationWithLatch, ReadBufferOperation>
+void gltf::CompactDocument::AccessorsSchema::read_object(vsg::JSONParser& parser, const std::string_view& property)
+{
+    if (property == "sparse")
     {
-        vsg::ref_ptr<Buffer> buffer;
-        uint32_t byteOffset = 0;
-        uint32_t byteLength = 0;
-        vsg::ref_ptr<BufferView> bufferView;
-        vsg::ref_ptr<const vsg::Options> options;
-        vsg::ref_ptr<vsg::Data>& data;
+        // sparse accessors aren't supported by the SceneGraphBuilder so aren't retained
+        std::string_view json;
+        gltf::read_json(parser, json);
+    }
+    else document->read_extensionsExtras(parser, property, document->accessors.extensionsExtras.back());
+}
 
-        ReadBufferOperation(vsg::ref_ptr<Buffer> b, uint32_t offset, uint32_t length, vsg::ref_ptr<const vsg::Options> o, vsg::ref_ptr<vsg::Data>& d, vsg::ref_ptr<vsg::Latch> l = {}) :
-            Inherit(l),
-            buffer(b),
-            byteOffset(offset),
-            byteLength(length),
-            options(o),
-            data(d) {}
+void gltf::CompactDocument::AccessorsSchema::read_string(vsg::JSONParser& parser, const std::string_view& property)
+{
+    auto& accessors = document->accessors;
+    if (property == "type") accessors.type.back() = document->read_string(parser);
+    else if (property == "name") accessors.name.back() = document->read_string(parser);
+    else parser.warning();
+}
 
-        void run() override
-        {
-            if (!buffer->data)
-            {
-                vsg::warn("Cannot read for empty buffer.");
-                return;
-            }
+void gltf::CompactDocument::AccessorsSchema::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
+{
+    auto& accessors = document->accessors;
+    if (property == "bufferView") read_value(parser, input, accessors.bufferView.back());
+    else if (property == "byteOffset") read_value(parser, input, accessors.byteOffset.back());
+    else if (property == "componentType") read_value(parser, input, accessors.componentType.back());
+    else if (property == "count") read_value(parser, input, accessors.count.back());
+    else parser.warning();
+}
 
-            auto ptr = reinterpret_cast<uint8_t*>(buffer->data->dataPointer()) + byteOffset;
+void gltf::CompactDocument::AccessorsSchema::read_bool(vsg::JSONParser& parser, const std::string_view& property, bool value)
+{
+    if (property == "normalized") document->accessors.normalized.back() = value ? 1 : 0;
+    else parser.warning();
+}
 
-            data = vsg::read_cast<vsg::Data>(ptr, byteLength, options);
+void gltf::CompactDocument::BufferViewsSchema::read_object(vsg::JSONParser& parser)
+{
+    document->bufferViews.push_back();
+    parser.read_object(*this);
+}
 
-            //vsg::info("Read buffer byteLength = ", byteLength, ", data = ", data);
-            // if (data) vsg::write(data, vsg::make_string("image_", byteOffset,".png"), options);
+void gltf::CompactDocument::BufferViewsSchema::read_object(vsg::JSONParser& parser, const std::string_view& property)
+{
+    document->read_extensionsExtras(parser, property, document->bufferViews.extensionsExtras.back());
+}
 
-            if (latch) latch->count_down();
-        }
-    };
+void gltf::CompactDocument::BufferViewsSchema::read_string(vsg::JSONParser& parser, const std::string_view& property)
+{
+    if (property == "name") document->bufferViews.name.back() = document->read_string(parser);
+    else parser.warning();
+}
 
-    struct DecodeOperation : public vsg::Inherit<OperationWithLatch, DecodeOperation>
-    {
-        std::string_view mimeType;
-        std::string_view encoding;
-        std::string_view value;
-        vsg::ref_ptr<const vsg::Options> options;
-        uint32_t byteLength;
-        vsg::ref_ptr<vsg::Data>& data;
+void gltf::CompactDocument::BufferViewsSchema::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
+{
+    auto& bufferViews = document->bufferViews;
+    if (property == "buffer") read_value(parser, input, bufferViews.buffer.back());
+    else if (property == "byteOffset") read_value(parser, input, bufferViews.byteOffset.back());
+    else if (property == "byteLength") read_value(parser, input, bufferViews.byteLength.back());
+    else if (property == "byteStride") read_value(parser, input, bufferViews.byteStride.back());
+    else if (property == "target") read_value(parser, input, bufferViews.target.back());
+    else parser.warning();
+}
 
-        DecodeOperation(const std::string_view& m, const std::string_view& e, const std::string_view& v, vsg::ref_ptr<const vsg::Options> o, vsg::ref_ptr<vsg::Data>& d, uint32_t bl, vsg::ref_ptr<vsg::Latch> l = {}) :
-            Inherit(l),
-            mimeType(m),
-            encoding(e),
-            value(v),
-            options(o),
-            byteLength(bl),
-            data(d) {}
+void gltf::CompactDocument::NodesSchema::read_object(vsg::JSONParser& parser)
+{
+    document->nodes.push_back();
+    parser.read_object(*this);
+}
 
-        void run() override
-        {
-            if (encoding == "base64")
-            {
-                auto valid_base64 = [](char c) -> uint8_t
-                {
-                    if (c >= 'A' && c <= 'Z') return true;
-                    if (c >= 'a' && c <= 'z') return true;
-                    if (c >= '0' && c <= '9') return true;
-                    if (c == '+') return true;
-                    if (c == '/') return true;
-                    return false;
+void gltf::CompactDocument::NodesSchema::read_array(vsg::JSONParser& parser, const std::string_view& property)
+{
+    auto& nodes = document->nodes;
+    if (property == "children") nodes.children.back() = document->read_ids(parser);
+    else if (property == "matrix") nodes.matrix.back() = document->read_doubles(parser);
+    else if (property == "rotation") nodes.rotation.back() = document->read_doubles(parser);
+    else if (property == "scale") nodes.scale.back() = document->read_doubles(parser);
+    else if (property == "translation") nodes.translation.back() = document->read_doubles(parser);
+    else if (property == "weights") nodes.weights.back() = document->read_doubles(parser);
+    else parser.warning();
+}
+
+void gltf::CompactDocument::NodesSchema::read_object(vsg::JSONParser& parser, const std::string_view& property)
+{
+    document->read_extensionsExtras(parser, property, document->nodes.extensionsExtras.back());
+}
+
+void gltf::CompactDocument::NodesSchema::read_string(vsg::JSONParser& parser, const std::string_view& property)
+{
+    if (property == "name") document->nodes.name.back() = document->read_string(parser);
+    else parser.warning();
+}
+
+void gltf::CompactDocument::NodesSchema::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
+{
+    auto& nodes = document->nodes;
+    if (property == "camera") read_value(parser, input, nodes.camera.back());
+    else if (property == "skin") read_value(parser, input, nodes.skin.back());
+    else if (property == "mesh") read_value(parser, input, nodes.mesh.back());
+    else parser.warning();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// Summary
+//
+const std::string gltf::Summary::key("gltf::Summary");
+
+static vsg::RegisterWithObjectFactoryProxy<gltf::Summary> s_Register_Summary;
+
+void gltf::Summary::read(vsg::Input& input)
+{
+    auto readStrings = [&input](const char* countName, const char* propertyName, std::vector<std::string>& strings) {
+        uint32_t count = 0;
+        input.read(countName, count);
+        strings.resize(count);
+        for(auto& str : strings) input.read(propertyName, str);
+    };
+
+    vsg::Object::read(input);
+
+    input.read("version", version);
+    input.read("generator", generator);
+
+    input.read("numAccessors", numAccessors);
+    input.read("numBufferViews", numBufferViews);
+    input.read("numBuffers", numBuffers);
+    input.read("numImages", numImages);
+    input.read("numTextures", numTextures);
+    input.read("numMaterials", numMaterials);
+    input.read("numMeshes", numMeshes);
+    input.read("numPrimitives", numPrimitives);
+    input.read("numNodes", numNodes);
+    input.read("numScenes", numScenes);
+    input.read("numAnimations", numAnimations);
+    input.read("numCameras", numCameras);
+    input.read("numSkins", numSkins);
+
+    readStrings("numNodeNames", "nodeName", nodeNames);
+    readStrings("numMeshNames", "meshName", meshNames);
+    readStrings("numMaterialNames", "materialName", materialNames);
+    readStrings("numExtensionsUsed", "extensionUsed", extensionsUsed);
+    readStrings("numExtensionsRequired", "extensionRequired", extensionsRequired);
+
+    input.read("bounds_min", bounds.min);
+    input.read("bounds_max", bounds.max);
+}
+
+void gltf::Summary::write(vsg::Output& output) const
+{
+    auto writeStrings = [&output](const char* countName, const char* propertyName, const std::vector<std::string>& strings) {
+        uint32_t count = static_cast<uint32_t>(strings.size());
+        output.write(countName, count);
+        for(auto& str : strings) output.write(propertyName, str);
+    };
+
+    vsg::Object::write(output);
+
+    output.write("version", version);
+    output.write("generator", generator);
+
+    output.write("numAccessors", numAccessors);
+    output.write("numBufferViews", numBufferViews);
+    output.write("numBuffers", numBuffers);
+    output.write("numImages", numImages);
+    output.write("numTextures", numTextures);
+    output.write("numMaterials", numMaterials);
+    output.write("numMeshes", numMeshes);
+    output.write("numPrimitives", numPrimitives);
+    output.write("numNodes", numNodes);
+    output.write("numScenes", numScenes);
+    output.write("numAnimations", numAnimations);
+    output.write("numCameras", numCameras);
+    output.write("numSkins", numSkins);
+
+    writeStrings("numNodeNames", "nodeName", nodeNames);
+    writeStrings("numMeshNames", "meshName", meshNames);
+    writeStrings("numMaterialNames", "materialName", materialNames);
+    writeStrings("numExtensionsUsed", "extensionUsed", extensionsUsed);
+    writeStrings("numExtensionsRequired", "extensionRequired", extensionsRequired);
+
+    output.write("bounds_min", bounds.min);
+    output.write("bounds_max", bounds.max);
+}
+
+void gltf::Summary::report()
+{
+    vsg::info("Summary { ");
+    vsg::info("    version: ", version, ", generator: ", generator);
+    vsg::info("    accessors: ", numAccessors, ", bufferViews: ", numBufferViews, ", buffers: ", numBuffers);
+    vsg::info("    images: ", numImages, ", textures: ", numTextures, ", materials: ", numMaterials);
+    vsg::info("    meshes: ", numMeshes, ", primitives: ", numPrimitives, ", nodes: ", numNodes, ", scenes: ", numScenes);
+    vsg::info("    animations: ", numAnimations, ", cameras: ", numCameras, ", skins: ", numSkins);
+    vsg::info("    names: nodes = ", nodeNames.size(), ", meshes = ", meshNames.size(), ", materials = ", materialNames.size());
+    for(auto& extension : extensionsUsed) vsg::info("    extensionUsed: ", extension);
+    for(auto& extension : extensionsRequired) vsg::info("    extensionRequired: ", extension);
+    if (bounds.valid()) vsg::info("    bounds: ", bounds.min, " -> ", bounds.max);
+    vsg::info("} ");
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////
+//
+// glTF
+//
+void gltf::glTF::report()
+{
+    vsg::info("\nglTF {");
+    if (asset) asset->report();
+    if (compact) compact->report();
+    accessors.report();
+    bufferViews.report();
+    buffers.report();
+    images.report();
+    materials.report();
+    meshes.report();
+    nodes.report();
+    samplers.report();
+    vsg::info("scene = ", scene);
+    scenes.report();
+    textures.report();
+    animations.report();
+    cameras.report();
+    skins.report();
+    vsg::info("}\n");
+}
+
+namespace
+{
+    // find the start and end positions of each object in the array at parser.pos, leaving parser.pos after the array's closing ']'.
+    // Returns false, restoring parser.pos, if the array holds anything other than objects.
+    bool array_elements(vsg::JSONParser& parser, std::vector<std::pair<size_t, size_t>>& elements)
+    {
+        auto& buffer = parser.buffer;
+        size_t start = parser.pos;
+        if (start >= buffer.size() || buffer[start] != '[') return false;
+
+        // use the StructuralIndex when available to hop from each object to the next without touching their contents
+        if (auto structuralIndex = parser.getObject<gltf::StructuralIndex>(gltf::StructuralIndex::key))
+        {
+            const uint32_t invalid = gltf::StructuralIndex::invalid_index;
+            auto& positions = structuralIndex->positions;
+            auto& matching = structuralIndex->matching;
+
+            uint32_t i = structuralIndex->index(start);
+            if (i != invalid && matching[i] != invalid)
+            {
+                uint32_t end = matching[i];
+                for(uint32_t j = i + 1; j < end;)
+                {
+                    char c = buffer[positions[j]];
+                    if (c == ',')
+                    {
+                        ++j;
+                        continue;
+                    }
+
+                    if (c != '{' || matching[j] == invalid)
+                    {
+                        elements.clear();
+                        return false;
+                    }
+
+                    elements.emplace_back(positions[j], positions[matching[j]]);
+                    j = matching[j] + 1;
+                }
+
+                parser.pos = positions[end] + 1;
+                return true;
+            }
+        }
+
+        // otherwise scan the array an object at a time
+        const char* whitespace = " \t\r\n";
+        parser.pos = buffer.find_first_not_of(whitespace, start + 1);
+        while (parser.pos != std::string::npos && buffer[parser.pos] == '{')
+        {
+            size_t element_start = parser.pos;
+            std::string_view json;
+            if (!gltf::read_json(parser, json)) break;
+
+            elements.emplace_back(element_start, parser.pos - 1);
+
+            parser.pos = buffer.find_first_not_of(whitespace, parser.pos);
+            if (parser.pos != std::string::npos && buffer[parser.pos] == ',') parser.pos = buffer.find_first_not_of(whitespace, parser.pos + 1);
+        }
+
+        if (parser.pos == std::string::npos || buffer[parser.pos] != ']')
+        {
+            parser.pos = start;
+            elements.clear();
+            return false;
+        }
+
+        ++parser.pos;
+        return true;
+    }
+
+    // read the array of objects at parser.pos, in parallel when the glTF has operationThreads assigned and the array is large enough.
+    // Each operation reads a contiguous range of elements with its own JSONParser into preallocated slots so the result matches a serial parse.
+    template<class T>
+    void read_objects(gltf::glTF& root, vsg::JSONParser& parser, vsg::ObjectsSchema<T>& objects)
+    {
+        size_t start = parser.pos;
+        std::vector<std::pair<size_t, size_t>> elements;
+        if (!root.operationThreads || !array_elements(parser, elements))
+        {
+            parser.pos = start;
+            parser.read_array(objects);
+            return;
+        }
+
+        size_t end = parser.pos;
+        size_t offset = objects.values.size();
+        size_t numElements = elements.size();
+        objects.values.resize(offset + numElements);
+
+        if (numElements < root.minimumParallelElements)
+        {
+            for(size_t i = 0; i < numElements; ++i)
+            {
+                parser.pos = elements[i].first;
+                auto object = T::create();
+                parser.read_object(*object);
+                objects.values[offset + i] = object;
+            }
+            parser.pos = end;
+            return;
+        }
+
+        size_t chunkSize = std::max(size_t(256), numElements / 64);
+        size_t numChunks = (numElements + chunkSize - 1) / chunkSize;
+
+        // set up the parsers on this thread as root.parsers isn't thread safe
+        std::vector<vsg::JSONParser*> chunkParsers(numChunks);
+        auto extensionRegistry = parser.getRefObject(gltf::ExtensionRegistry::key);
+        auto lazyExtras = parser.getRefObject(gltf::LazyExtras::key);
+        auto summary = parser.getRefObject(gltf::Summary::key);
+        for(auto& chunkParser : chunkParsers)
+        {
+            auto& localParser = root.parsers.emplace_back();
+            localParser.options = parser.options;
+            localParser.level = parser.level;
+            if (extensionRegistry) localParser.setObject(gltf::ExtensionRegistry::key, extensionRegistry);
+            if (lazyExtras) localParser.setObject(gltf::LazyExtras::key, lazyExtras);
+            if (summary) localParser.setObject(gltf::Summary::key, summary);
+            chunkParser = &localParser;
+        }
+
+        gltf::parallel_for(root.operationThreads, numChunks, [&](size_t c) {
+            size_t first = c * chunkSize;
+            size_t last = std::min(first + chunkSize, numElements);
+
+            auto& localParser = *chunkParsers[c];
+            size_t sliceStart = elements[first].first;
+            localParser.buffer.assign(parser.buffer, sliceStart, elements[last - 1].second + 1 - sliceStart);
+
+            for(size_t i = first; i < last; ++i)
+            {
+                localParser.pos = elements[i].first - sliceStart;
+                auto object = T::create();
+                localParser.read_object(*object);
+                objects.values[offset + i] = object;
+            }
+        });
+
+        for(auto& chunkParser : chunkParsers) parser.warningCount += chunkParser->warningCount;
+
+        parser.pos = end;
+    }
+}
+
+void gltf::glTF::read_array(vsg::JSONParser& parser, const std::string_view& property)
+{
+    if (property == "extensionsUsed") parser.read_array(extensionsUsed);
+    else if (property == "extensionsRequired") parser.read_array(extensionsRequired);
+    else if (property == "accessors")
+    {
+        if (compact)
+        {
+            CompactDocument::AccessorsSchema schema;
+            schema.document = compact.get();
+            parser.read_array(schema);
+        }
+        else read_objects(*this, parser, accessors);
+    }
+    else if (property == "animations")
+    {
+        if (structureOnly)
+        {
+            // keep a placeholder per animation so they can be counted, but skip over their channels and samplers
+            struct SkipAnimations : public vsg::JSONParser::Schema
+            {
+                vsg::ObjectsSchema<Animation>& animations;
+                explicit SkipAnimations(vsg::ObjectsSchema<Animation>& in_animations) : animations(in_animations) {}
+
+                void read_object(vsg::JSONParser& p) override
+                {
+                    animations.values.push_back(Animation::create());
+                    std::string_view json;
+                    gltf::read_json(p, json);
+                }
+            } skipAnimations(animations);
+
+            parser.read_array(skipAnimations);
+        }
+        else parser.read_array(animations);
+    }
+    else if (property == "buffers") parser.read_array(buffers);
+    else if (property == "bufferViews")
+    {
+        if (compact)
+        {
+            CompactDocument::BufferViewsSchema schema;
+            schema.document = compact.get();
+            parser.read_array(schema);
+        }
+        else read_objects(*this, parser, bufferViews);
+    }
+    else if (property == "cameras")  parser.read_array(cameras);
+    else if (property == "materials") parser.read_array(materials);
+    else if (property == "meshes") read_objects(*this, parser, meshes);
+    else if (property == "nodes")
+    {
+        if (compact)
+        {
+            CompactDocument::NodesSchema schema;
+            schema.document = compact.get();
+            parser.read_array(schema);
+        }
+        else read_objects(*this, parser, nodes);
+    }
+    else if (property == "samplers") parser.read_array(samplers);
+    else if (property == "scenes") parser.read_array(scenes);
+    else if (property == "skins") parser.read_array(skins);
+    else if (property == "images") parser.read_array(images);
+    else if (property == "textures") parser.read_array(textures);
+    else parser.warning();
+}
+
+void gltf::glTF::read_object(vsg::JSONParser& parser, const std::string_view& property)
+{
+    if (property == "asset")
+    {
+        asset = gltf::Asset::create();
+        parser.read_object(*asset);
+    }
+    else ExtensionsExtras::read_object(parser, property);
+}
+
+void gltf::glTF::read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input)
+{
+    if (property == "scene") read_value(parser, input, scene);
+    else parser.warning();
+}
+
+vsg::ref_ptr<gltf::Summary> gltf::glTF::createSummary(vsg::ref_ptr<const vsg::Options> options)
+{
+    auto summary = Summary::create();
+
+    if (asset)
+    {
+        summary->version = asset->version;
+        summary->generator = asset->generator;
+    }
+
+    size_t numNodes = compact ? compact->nodes.size() : nodes.values.size();
+
+    summary->numAccessors = static_cast<uint32_t>(compact ? compact->accessors.size() : accessors.values.size());
+    summary->numBufferViews = static_cast<uint32_t>(compact ? compact->bufferViews.size() : bufferViews.values.size());
+    summary->numBuffers = static_cast<uint32_t>(buffers.values.size());
+    summary->numImages = static_cast<uint32_t>(images.values.size());
+    summary->numTextures = static_cast<uint32_t>(textures.values.size());
+    summary->numMaterials = static_cast<uint32_t>(materials.values.size());
+    summary->numMeshes = static_cast<uint32_t>(meshes.values.size());
+    summary->numNodes = static_cast<uint32_t>(numNodes);
+    summary->numScenes = static_cast<uint32_t>(scenes.values.size());
+    summary->numAnimations = static_cast<uint32_t>(animations.values.size());
+    summary->numCameras = static_cast<uint32_t>(cameras.values.size());
+    summary->numSkins = static_cast<uint32_t>(skins.values.size());
+
+    summary->extensionsUsed = extensionsUsed.values;
+    summary->extensionsRequired = extensionsRequired.values;
+
+    for(auto& material : materials.values)
+    {
+        if (!material->name.empty()) summary->materialNames.push_back(material->name);
+    }
+
+    // parse the min/max JSON retained by a structure only parse
+    auto readDoubles = [](const std::string_view& json, NumberValues<double>& values) {
+        if (json.empty() || !values.values.empty()) return;
+
+        vsg::JSONParser parser;
+        parser.buffer = json;
+        parser.pos = 0;
+        parser.read_array(values);
+    };
+
+    // bounds of each mesh from the min/max of its POSITION accessors
+    auto positionBounds = [&](glTFid id, vsg::dbox& bounds) {
+        if (!id) return;
+
+        const double* min_ptr = nullptr;
+        const double* max_ptr = nullptr;
+        if (compact)
+        {
+            if (id.value >= compact->accessors.size()) return;
+
+            auto& min = compact->accessors.min[id.value];
+            auto& max = compact->accessors.max[id.value];
+            if (min.count < 3 || max.count < 3) return;
+
+            min_ptr = compact->values(min);
+            max_ptr = compact->values(max);
+        }
+        else
+        {
+            if (id.value >= accessors.values.size()) return;
+
+            auto& accessor = accessors.values[id.value];
+            readDoubles(accessor->minJSON, accessor->min);
+            readDoubles(accessor->maxJSON, accessor->max);
+            if (accessor->min.values.size() < 3 || accessor->max.values.size() < 3) return;
+
+            min_ptr = accessor->min.values.data();
+            max_ptr = accessor->max.values.data();
+        }
+
+        bounds.add(min_ptr[0], min_ptr[1], min_ptr[2]);
+        bounds.add(max_ptr[0], max_ptr[1], max_ptr[2]);
+    };
+
+    std::vector<vsg::dbox> meshBounds(meshes.values.size());
+    for(size_t mi = 0; mi < meshes.values.size(); ++mi)
+    {
+        auto& mesh = meshes.values[mi];
+        if (!mesh->name.empty()) summary->meshNames.push_back(mesh->name);
+
+        for(auto& primitive : mesh->primitives.values)
+        {
+            ++(summary->numPrimitives);
+
+            auto itr = primitive->attributes.values.find("POSITION");
+            if (itr != primitive->attributes.values.end()) positionBounds(itr->second, meshBounds[mi]);
+        }
+    }
+
+    // node properties from either representation
+    auto nodeMesh = [&](size_t ni) { return compact ? compact->nodes.mesh[ni] : nodes.values[ni]->mesh; };
+
+    auto nodeChildren = [&](size_t ni, const glTFid*& children) -> size_t {
+        if (compact)
+        {
+            children = compact->children(static_cast<uint32_t>(ni));
+            return compact->nodes.children[ni].count;
+        }
+        children = nodes.values[ni]->children.values.data();
+        return nodes.values[ni]->children.values.size();
+    };
+
+    auto localMatrix = [&](size_t ni) {
+        if (compact)
+        {
+            auto& n = compact->nodes;
+            return gltf::nodeMatrix(compact->values(n.matrix[ni]), n.matrix[ni].count, compact->values(n.translation[ni]), n.translation[ni].count,
+                                    compact->values(n.rotation[ni]), n.rotation[ni].count, compact->values(n.scale[ni]), n.scale[ni].count);
+        }
+        auto& n = nodes.values[ni];
+        return gltf::nodeMatrix(n->matrix.values.data(), n->matrix.values.size(), n->translation.values.data(), n->translation.values.size(),
+                                n->rotation.values.data(), n->rotation.values.size(), n->scale.values.data(), n->scale.values.size());
+    };
+
+    for(size_t ni = 0; ni < numNodes; ++ni)
+    {
+        std::string_view name = compact ? compact->string(compact->nodes.name[ni]) : std::string_view(nodes.values[ni]->name);
+        if (!name.empty()) summary->nodeNames.emplace_back(name);
+    }
+
+    // root nodes of the default scene, or the nodes without parents when there are no scenes
+    std::vector<glTFid> rootNodes;
+    if (!scenes.values.empty())
+    {
+        size_t sceneIndex = (scene && scene.value < scenes.values.size()) ? scene.value : 0;
+        rootNodes = scenes.values[sceneIndex]->nodes.values;
+    }
+    else
+    {
+        std::vector<bool> hasParent(numNodes, false);
+        for(size_t ni = 0; ni < numNodes; ++ni)
+        {
+            const glTFid* children = nullptr;
+            size_t numChildren = nodeChildren(ni, children);
+            for(size_t ci = 0; ci < numChildren; ++ci)
+            {
+                if (children[ci].value < numNodes) hasParent[children[ci].value] = true;
+            }
+        }
+        for(size_t ni = 0; ni < numNodes; ++ni)
+        {
+            if (!hasParent[ni]) rootNodes.push_back(glTFid{static_cast<uint32_t>(ni)});
+        }
+    }
+
+    vsg::dmat4 sceneMatrix;
+    vsg::CoordinateConvention destination_coordinateConvention = vsg::CoordinateConvention::Z_UP;
+    if (options) destination_coordinateConvention = options->sceneCoordinateConvention;
+    vsg::transform(vsg::CoordinateConvention::Y_UP, destination_coordinateConvention, sceneMatrix);
+
+    // accumulate the transformed mesh bounds, the depth limit guards against malformed files with cycles in the hierarchy
+    struct Entry
+    {
+        uint32_t node;
+        size_t depth;
+        vsg::dmat4 matrix;
+    };
+
+    std::vector<Entry> stack;
+    for(auto& id : rootNodes)
+    {
+        if (id.value < numNodes) stack.push_back(Entry{id.value, 0, sceneMatrix});
+    }
+
+    while(!stack.empty())
+    {
+        auto entry = stack.back();
+        stack.pop_back();
+
+        auto matrix = entry.matrix * localMatrix(entry.node);
+
+        auto mesh = nodeMesh(entry.node);
+        if (mesh && mesh.value < meshBounds.size() && meshBounds[mesh.value].valid())
+        {
+            auto& mb = meshBounds[mesh.value];
+            for(int corner = 0; corner < 8; ++corner)
+            {
+                vsg::dvec3 v((corner & 1) ? mb.max.x : mb.min.x, (corner & 2) ? mb.max.y : mb.min.y, (corner & 4) ? mb.max.z : mb.min.z);
+                summary->bounds.add(matrix * v);
+            }
+        }
+
+        if (entry.depth >= numNodes) continue;
+
+        const glTFid* children = nullptr;
+        size_t numChildren = nodeChildren(entry.node, children);
+        for(size_t ci = 0; ci < numChildren; ++ci)
+        {
+            if (children[ci].value < numNodes) stack.push_back(Entry{children[ci].value, entry.depth + 1, matrix});
+        }
+    }
+
+    return summary;
+}
+
+void gltf::glTF::resolveURIs(vsg::ref_ptr<const vsg::Options> options)
+{
+    vsg::ref_ptr<vsg::OperationThreads> operationThreads;
+    vsg::ref_ptr<const ResourceCache> resourceCache;
+    if (options)
+    {
+        operationThreads = options->operationThreads;
+        resourceCache = options->getRefObject<ResourceCache>(ResourceCache::key);
+    }
+
+    auto dataURI = [](const std::string_view& uri, std::string_view& mimeType, std::string_view& encoding, std::string_view& value) -> bool
+    {
+        if (uri.size() <= 5) return false;
+        if (uri.compare(0, 5, "data:") != 0) return false;
+
+
+        auto semicolon = uri.find(';', 6);
+        auto comma = uri.find(',', semicolon+1);
+
+        mimeType = std::string_view(&uri[5], semicolon-5);
+        encoding = std::string_view(&uri[semicolon+1], comma - semicolon-1);
+        value = std::string_view(&uri[comma+1], uri.size() - comma -1);
+
+        return true;
+    };
+
+    auto mimeTypeToExtension = [](const std::string_view& mimeType) -> vsg::Path
+    {
+        if (mimeType=="image/png") return ".png";
+        else if (mimeType=="image/jpeg") return ".jpeg";
+        else if (mimeType=="image/bmp") return ".bmp";
+        else if (mimeType=="image/gif") return ".gif";
+        else if (mimeType=="image/ktx") return ".ktx";
+        return "";
+    };
+
+    struct OperationWithLatch : public vsg::Inherit<vsg::Operation, OperationWithLatch>
+    {
+        vsg::ref_ptr<vsg::Latch> latch;
+
+        OperationWithLatch(vsg::ref_ptr<vsg::Latch> l) : latch(l) {}
+    };
+
+    struct ReadFileOperation : public vsg::Inherit<OperationWithLatch, ReadFileOperation>
+    {
+        std::string_view filename;
+        vsg::ref_ptr<const vsg::Options> options;
+        vsg::ref_ptr<vsg::Data>& data;
+        vsg::ref_ptr<const ResourceCache> resourceCache;
+
+        ReadFileOperation(const std::string_view& f, vsg::ref_ptr<const vsg::Options> o, vsg::ref_ptr<vsg::Data>& d, vsg::ref_ptr<const ResourceCache> rc, vsg::ref_ptr<vsg::Latch> l = {}) :
+            Inherit(l),
+            filename(f),
+            options(o),
+            data(d),
+            resourceCache(rc) {}
+
+        void run() override
+        {
+            if (resourceCache) data = resourceCache->read(std::string(filename), options);
+            else data = vsg::read_cast<vsg::Data>(std::string(filename), options);
+
+            if (latch) latch->count_down();
+        }
+    };
+
+    struct ReadBufferOperation : public vsg::Inherit<OperationWithLatch, ReadBufferOperation>
+    {
+        vsg::ref_ptr<Buffer> buffer;
+        uint32_t byteOffset = 0;
+        uint32_t byteLength = 0;
+        vsg::ref_ptr<BufferView> bufferView;
+        vsg::ref_ptr<const vsg::Options> options;
+        vsg::ref_ptr<vsg::Data>& data;
+
+        ReadBufferOperation(vsg::ref_ptr<Buffer> b, uint32_t offset, uint32_t length, vsg::ref_ptr<const vsg::Options> o, vsg::ref_ptr<vsg::Data>& d, vsg::ref_ptr<vsg::Latch> l = {}) :
+            Inherit(l),
+            buffer(b),
+            byteOffset(offset),
+            byteLength(length),
+            options(o),
+            data(d) {}
+
+        void run() override
+        {
+            if (!buffer->data)
+            {
+                vsg::warn("Cannot read for empty buffer.");
+                return;
+            }
+
+            auto ptr = reinterpret_cast<uint8_t*>(buffer->data->dataPointer()) + byteOffset;
+
+            data = vsg::read_cast<vsg::Data>(ptr, byteLength, options);
+
+            //vsg::info("Read buffer byteLength = ", byteLength, ", data = ", data);
+            // if (data) vsg::write(data, vsg::make_string("image_", byteOffset,".png"), options);
+
+            if (latch) latch->count_down();
+        }
+    };
+
+    struct DecodeOperation : public vsg::Inherit<OperationWithLatch, DecodeOperation>
+    {
+        std::string_view mimeType;
+        std::string_view encoding;
+        std::string_view value;
+        vsg::ref_ptr<const vsg::Options> options;
+        uint32_t byteLength;
+        vsg::ref_ptr<vsg::Data>& data;
+        vsg::ref_ptr<vsg::Data> streamedData;
+
+        DecodeOperation(const std::string_view& m, const std::string_view& e, const std::string_view& v, vsg::ref_ptr<const vsg::Options> o, vsg::ref_ptr<vsg::Data>& d, uint32_t bl, vsg::ref_ptr<vsg::Latch> l = {}) :
+            Inherit(l),
+            mimeType(m),
+            encoding(e),
+            value(v),
+            options(o),
+            byteLength(bl),
+            data(d) {}
+
+        void run() override
+        {
+            vsg::ref_ptr<vsg::Data> decoded;
+            if (encoding == "base64")
+            {
+                auto valid_base64 = [](char c) -> uint8_t
+                {
+                    if (c >= 'A' && c <= 'Z') return true;
+                    if (c >= 'a' && c <= 'z') return true;
+                    if (c >= '0' && c <= '9') return true;
+                    if (c == '+') return true;
+                    if (c == '/') return true;
+                    return false;
                 };
 
                 auto decode_base64 = [](char c) -> uint8_t
@@ -1010,6 +1908,21 @@ void gltf::glTF::resolveURIs(vsg::ref_ptr<const vsg::Options> options)
                     *dest_itr = 0;
                 }
 
+                decoded = decodedData;
+            }
+            else if (encoding == "streamed")
+            {
+                // already decoded by gltf::read_streamed(..), release it from the operation once consumed
+                decoded = streamedData;
+                streamedData = {};
+            }
+            else
+            {
+                vsg::warn("Error: encoding not supported. mimeType = ", mimeType, ", encoding = ", encoding);
+            }
+
+            if (decoded)
+            {
                 auto readData = [](vsg::ref_ptr<vsg::Data> input,  vsg::ref_ptr<const vsg::Options> opt, const vsg::Path& extensionHint) -> vsg::ref_ptr<vsg::Data>
                 {
                     auto local_options = vsg::clone(opt);
@@ -1034,7 +1947,7 @@ void gltf::glTF::resolveURIs(vsg::ref_ptr<const vsg::Options> options)
                 {
                     if (auto extensionHint = gltf::mimeTypeToExtension(mimeType); !extensionHint.empty())
                     {
-                        data = readData(decodedData, options, extensionHint);
+                        data = readData(decoded, options, extensionHint);
                     }
                     else
                     {
@@ -1045,18 +1958,40 @@ void gltf::glTF::resolveURIs(vsg::ref_ptr<const vsg::Options> options)
                 {
                     // vsg::info("We have a data URI : mimeType = ", mimeType, ", encoding = ", encoding, ", value.size() = ", value.size());
 
-                    data = decodedData;
+                    data = decoded;
                 }
             }
-            else
-            {
-                vsg::warn("Error: encoding not supported. mimeType = ", mimeType, ", encoding = ", encoding);
-            }
 
             if (latch) latch->count_down();
         }
     };
 
+    // each streamed entry is referenced by a single data URI, so release it from streamedData once taken
+    auto streamed = [&](const std::string_view& value) -> vsg::ref_ptr<vsg::Data>
+    {
+        size_t index = 0;
+        auto result = std::from_chars(value.data(), value.data() + value.size(), index);
+        if (result.ec != std::errc() || index >= streamedData.size()) return {};
+
+        auto data = streamedData[index];
+        streamedData[index] = {};
+        return data;
+    };
+
+    // clamp or zero pad the decoded data to the buffer's byteLength, as the base64 DecodeOperation does
+    auto resize = [](vsg::ref_ptr<vsg::Data> data, uint32_t byteLength) -> vsg::ref_ptr<vsg::Data>
+    {
+        if (!data || data->dataSize() == byteLength) return data;
+
+        vsg::warn("gltf::glTF::resolveURIs() streamed buffer decodes to ", data->dataSize(), " bytes, byteLength = ", byteLength);
+
+        auto resized = vsg::ubyteArray::create(byteLength);
+        size_t copySize = std::min(data->dataSize(), static_cast<size_t>(byteLength));
+        std::memcpy(resized->dataPointer(), data->dataPointer(), copySize);
+        std::memset(static_cast<uint8_t*>(resized->dataPointer()) + copySize, 0, byteLength - copySize);
+        return resized;
+    };
+
     std::vector<vsg::ref_ptr<OperationWithLatch>> operations;
     std::vector<vsg::ref_ptr<OperationWithLatch>> secondary_operations;
 
@@ -1069,11 +2004,12 @@ void gltf::glTF::resolveURIs(vsg::ref_ptr<const vsg::Options> options)
             std::string_view value;
             if (dataURI(buffer->uri, mimeType, encoding, value))
             {
-                operations.push_back(DecodeOperation::create(mimeType, encoding, value, options, buffer->data, buffer->byteLength));
+                if (encoding == "streamed") buffer->data = resize(streamed(value), buffer->byteLength);
+                else operations.push_back(DecodeOperation::create(mimeType, encoding, value, options, buffer->data, buffer->byteLength));
             }
             else
             {
-                operations.push_back(ReadFileOperation::create(buffer->uri, options, buffer->data));
+                operations.push_back(ReadFileOperation::create(buffer->uri, options, buffer->data, resourceCache));
             }
         }
     }
@@ -1089,24 +2025,39 @@ void gltf::glTF::resolveURIs(vsg::ref_ptr<const vsg::Options> options)
                 std::string_view value;
                 if (dataURI(image->uri, mimeType, encoding, value))
                 {
-                    operations.push_back(DecodeOperation::create(mimeType, encoding, value, options, image->data, std::numeric_limits<uint32_t>::max()));
+                    auto operation = DecodeOperation::create(mimeType, encoding, value, options, image->data, std::numeric_limits<uint32_t>::max());
+                    if (encoding == "streamed") operation->streamedData = streamed(value);
+                    operations.push_back(operation);
                 }
                 else
                 {
-                    operations.push_back(ReadFileOperation::create(image->uri, options, image->data));
+                    operations.push_back(ReadFileOperation::create(image->uri, options, image->data, resourceCache));
                 }
             }
             else if (image->bufferView)
             {
-                auto& bufferView = bufferViews.values[image->bufferView.value];
-                auto& buffer = buffers.values[bufferView->buffer.value];
+                uint32_t bufferId = 0, byteOffset = 0, byteLength = 0;
+                if (compact)
+                {
+                    bufferId = compact->bufferViews.buffer[image->bufferView.value].value;
+                    byteOffset = compact->bufferViews.byteOffset[image->bufferView.value];
+                    byteLength = compact->bufferViews.byteLength[image->bufferView.value];
+                }
+                else
+                {
+                    auto& bufferView = bufferViews.values[image->bufferView.value];
+                    bufferId = bufferView->buffer.value;
+                    byteOffset = bufferView->byteOffset;
+                    byteLength = bufferView->byteLength;
+                }
+                auto& buffer = buffers.values[bufferId];
 
                 if (auto extensionHint = gltf::mimeTypeToExtension(image->mimeType); !extensionHint.empty())
                 {
                     auto local_options = vsg::clone(options);
                     local_options->extensionHint = extensionHint;
 
-                    secondary_operations.push_back(ReadBufferOperation::create(buffer, bufferView->byteOffset, bufferView->byteLength, local_options, image->data));
+                    secondary_operations.push_back(ReadBufferOperation::create(buffer, byteOffset, byteLength, local_options, image->data));
                 }
             }
             else
@@ -1116,6 +2067,9 @@ void gltf::glTF::resolveURIs(vsg::ref_ptr<const vsg::Options> options)
         }
     }
 
+    // release any streamed data that no buffer or image referenced
+    streamedData.clear();
+
     if (operations.size() > 1 && operationThreads)
     {
         auto latch = vsg::Latch::create(static_cast<int>(operations.size()));
@@ -1179,6 +2133,9 @@ void gltf::glTF::resolveURIs(vsg::ref_ptr<const vsg::Options> options)
 //
 gltf::gltf()
 {
+    extensionRegistry = ExtensionRegistry::create();
+    extensionRegistry->add<KHR_materials_specular>("KHR_materials_specular");
+    extensionRegistry->add<KHR_materials_ior>("KHR_materials_ior");
 }
 
 bool gltf::supportedExtension(const vsg::Path& ext) const
@@ -1198,38 +2155,101 @@ vsg::ref_ptr<vsg::Object> gltf::_read(std::istream& fin, vsg::ref_ptr<const vsg:
     parser.options = options;
 
     // set up the supported extensions
-    parser.setObject("KHR_materials_specular", KHR_materials_specular::create());
-    parser.setObject("KHR_materials_ior", KHR_materials_ior::create());
+    parser.setObject(ExtensionRegistry::key, extensionRegistry);
+
+    if (vsg::value<bool>(false, gltf::lazy_extras, options)) parser.setObject(LazyExtras::key, vsg::boolValue::create(true));
+
+    bool queryEnabled = vsg::value<bool>(false, gltf::query, options);
+
+    if (queryEnabled) parser.setObject(Summary::key, vsg::boolValue::create(true));
+
+    auto root = gltf::glTF::create();
+    root->extensionRegistry = extensionRegistry;
+    root->structureOnly = queryEnabled;
+
+    // the compact document reduces the memory footprint of a full load, a structure only parse doesn't retain the bulk arrays it holds
+    if (!queryEnabled && vsg::value<bool>(false, gltf::compact_document, options)) root->compact = CompactDocument::create();
+    if (options && vsg::value<bool>(false, gltf::parallel_parse, options)) root->operationThreads = options->operationThreads;
 
-    parser.buffer.resize(fileSize);
     fin.seekg(0);
-    fin.read(reinterpret_cast<char*>(parser.buffer.data()), fileSize);
+    if (vsg::value<bool>(false, gltf::streaming, options))
+    {
+        if (!read_streamed(fin, parser.buffer, root->streamedData)) return {};
+    }
+    else
+    {
+        parser.buffer.resize(fileSize);
+        fin.read(reinterpret_cast<char*>(parser.buffer.data()), fileSize);
+    }
 
     vsg::ref_ptr<vsg::Object> result;
 
+    bool reportEnabled = vsg::value<bool>(false, gltf::report, options);
+
+    if (vsg::value<bool>(false, gltf::structural_index, options))
+    {
+        auto before_index = vsg::clock::now();
+
+        auto structuralIndex = StructuralIndex::create();
+        if (!structuralIndex->build(parser.buffer))
+        {
+            vsg::warn("glTF parsing error, unterminated string or unbalanced brackets : ", filename);
+            return {};
+        }
+        parser.setObject(StructuralIndex::key, structuralIndex);
+
+        if (reportEnabled)
+        {
+            vsg::info("glTF structural index : ", structuralIndex->positions.size(), " structurals, ", std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - before_index).count(), "ms, simd = ", StructuralIndex::simd(), " : ", filename);
+        }
+    }
+
     // skip white space
     parser.pos = parser.buffer.find_first_not_of(" \t\r\n", 0);
     if (parser.pos == std::string::npos) return {};
 
     if (parser.buffer[parser.pos]=='{')
     {
-        auto root = gltf::glTF::create();
+        auto milliseconds = [](vsg::clock::time_point start, vsg::clock::time_point end) { return std::chrono::duration<double, std::chrono::milliseconds::period>(end - start).count(); };
+
+        auto before_parse = vsg::clock::now();
 
         parser.warningCount = 0;
         parser.read_object(*root);
 
-        root->resolveURIs(options);
+        auto after_parse = vsg::clock::now();
 
         if (parser.warningCount != 0) vsg::warn("glTF parsing failure : ", filename);
         else vsg::debug("glTF parsing success : ", filename);
 
-        if (vsg::value<bool>(false, gltf::report, options))
+        if (queryEnabled)
+        {
+            // no buffers or images are read and no scene graph is built, just summarize the parsed JSON
+            auto summary = root->createSummary(options);
+            if (reportEnabled)
+            {
+                summary->report();
+                vsg::info("glTF timing : parse = ", milliseconds(before_parse, after_parse), "ms, summary = ", milliseconds(after_parse, vsg::clock::now()), "ms : ", filename);
+            }
+            return summary;
+        }
+
+        root->resolveURIs(options);
+
+        auto after_resolve = vsg::clock::now();
+
+        if (reportEnabled)
         {
             root->report();
         }
 
         auto builder = gltf::SceneGraphBuilder::create();
         result = builder->createSceneGraph(root, options);
+
+        if (reportEnabled)
+        {
+            vsg::info("glTF timing : parse = ", milliseconds(before_parse, after_parse), "ms, resolveURIs = ", milliseconds(after_parse, after_resolve), "ms, build = ", milliseconds(after_resolve, vsg::clock::now()), "ms : ", filename);
+        }
     }
     else
     {
@@ -1280,6 +2300,31 @@ bool gltf::readOptions(vsg::Options& options, vsg::CommandLine& arguments) const
 {
     bool result = arguments.readAndAssign<bool>(gltf::report, &options);
     result = arguments.readAndAssign<bool>(gltf::culling, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::streaming, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::compact_document, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::query, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::structural_index, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::parallel_parse, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::lazy_extras, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::optimize_geometry, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::generate_indices, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::interleave_vertices, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::meshlets, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(gltf::meshlet_vertices, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(gltf::meshlet_triangles, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::flatten_transforms, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::batch_geometry, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::simplify_graph, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::sort_state, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::share_content, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(gltf::max_texture_size, &options) || result;
+    result = arguments.readAndAssign<uint32_t>(gltf::texture_budget, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::prepare_images, &options) || result;
+    result = arguments.readAndAssign<std::string>(gltf::mipmap_filter, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::compress_images, &options) || result;
+    result = arguments.readAndAssign<std::string>(gltf::compression_quality, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::bc5_normals, &options) || result;
+    result = arguments.readAndAssign<bool>(gltf::release_buffers, &options) || result;
     return result;
 }
 
@@ -1317,3 +2362,407 @@ vsg::Path gltf::mimeTypeToExtension(const std::string_view& mimeType)
     else if (mimeType=="image/ktx") return ".ktx";
     return "";
 };
+
+vsg::dmat4 gltf::nodeMatrix(const double* m, size_t m_size, const double* t, size_t t_size, const double* r, size_t r_size, const double* s, size_t s_size)
+{
+    if (m_size==16)
+    {
+        vsg::dmat4 matrix;
+        matrix.set(m[0], m[1], m[2], m[3],
+                   m[4], m[5], m[6], m[7],
+                   m[8], m[9], m[10], m[11],
+                   m[12], m[13], m[14], m[15]);
+        return matrix;
+    }
+
+    vsg::dvec3 vsg_t(0.0, 0.0, 0.0);
+    vsg::dquat vsg_r;
+    vsg::dvec3 vsg_s(1.0, 1.0, 1.0);
+
+    if (t_size>=3) vsg_t.set(t[0], t[1], t[2]);
+    if (r_size>=4) vsg_r.set(r[0], r[1], r[2], r[3]);
+    if (s_size>=3) vsg_s.set(s[0], s[1], s[2]);
+
+    return vsg::translate(vsg_t) * vsg::rotate(vsg_r) * vsg::scale(vsg_s);
+}
+
+void gltf::parallel_for(vsg::ref_ptr<vsg::OperationThreads> operationThreads, size_t count, const std::function<void(size_t)>& func)
+{
+    if (!operationThreads || count <= 1)
+    {
+        for(size_t i = 0; i < count; ++i) func(i);
+        return;
+    }
+
+    struct ForOperation : public vsg::Inherit<vsg::Operation, ForOperation>
+    {
+        const std::function<void(size_t)>& func;
+        size_t index;
+        vsg::ref_ptr<vsg::Latch> latch;
+
+        ForOperation(const std::function<void(size_t)>& f, size_t i, vsg::ref_ptr<vsg::Latch> l) :
+            func(f),
+            index(i),
+            latch(l) {}
+
+        void run() override
+        {
+            func(index);
+            latch->count_down();
+        }
+    };
+
+    auto latch = vsg::Latch::create(static_cast<int>(count));
+    for(size_t i = 0; i < count; ++i)
+    {
+        operationThreads->add(ForOperation::create(func, i, latch));
+    }
+
+    // use this thread to run the operations as well
+    operationThreads->run();
+
+    // wait till all the operations have completed
+    latch->wait();
+}
+
+bool gltf::read_json(vsg::JSONParser& parser, std::string_view& json)
+{
+    auto& buffer = parser.buffer;
+    size_t start = parser.pos;
+    if (start >= buffer.size() || (buffer[start] != '{' && buffer[start] != '['))
+    {
+        parser.warning();
+        return false;
+    }
+
+    // use the StructuralIndex when available to jump straight to the closing bracket
+    if (auto structuralIndex = parser.getObject<StructuralIndex>(StructuralIndex::key))
+    {
+        if (size_t end = structuralIndex->closing(start); end != std::string::npos)
+        {
+            json = std::string_view(&buffer[start], end + 1 - start);
+            parser.pos = end + 1;
+            return true;
+        }
+    }
+
+    uint32_t depth = 0;
+    for(size_t i = start; i < buffer.size(); ++i)
+    {
+        char c = buffer[i];
+        if (c == '"')
+        {
+            // skip over the string, including any escaped characters
+            for(++i; i < buffer.size() && buffer[i] != '"'; ++i)
+            {
+                if (buffer[i] == '\\') ++i;
+            }
+        }
+        else if (c == '{' || c == '[')
+        {
+            ++depth;
+        }
+        else if (c == '}' || c == ']')
+        {
+            if (--depth == 0)
+            {
+                json = std::string_view(&buffer[start], i + 1 - start);
+                parser.pos = i + 1;
+                return true;
+            }
+        }
+    }
+
+    parser.warning();
+    parser.pos = std::string::npos;
+    return false;
+}
+
+bool gltf::read_streamed(std::istream& fin, std::string& buffer, std::vector<vsg::ref_ptr<vsg::Data>>& streamedData, size_t chunkSize)
+{
+    // incremental base64 decoder writing into blocks so the decoded size doesn't need to be known up front.
+    struct Base64Decoder
+    {
+        uint8_t lookup[256];
+        std::list<std::vector<uint8_t>> blocks;
+        size_t maxBlockSize = 4 << 20;
+        size_t size = 0;
+        size_t spanEnd = 0; // upper bound of size once the span passed to decode(..) is decoded
+        bool lastSpan = false;
+        uint32_t bits = 0;
+        uint32_t numSextets = 0;
+        uint32_t escape = 0; // 0 outside an escape, 1 after the \, 2 to 5 reading the hex digits of a \uXXXX escape
+        uint32_t codePoint = 0;
+
+        Base64Decoder()
+        {
+            for(uint32_t c = 0; c<256; ++c) lookup[c] = 0xff;
+            for(uint32_t c = 'A'; c<='Z'; ++c) lookup[c] = static_cast<uint8_t>(c - 'A');
+            for(uint32_t c = 'a'; c<='z'; ++c) lookup[c] = static_cast<uint8_t>(c - 'a' + 26);
+            for(uint32_t c = '0'; c<='9'; ++c) lookup[c] = static_cast<uint8_t>(c - '0' + 52);
+            lookup[static_cast<uint8_t>('+')] = 62;
+            lookup[static_cast<uint8_t>('/')] = 63;
+        }
+
+        void push_back(uint8_t value)
+        {
+            if (blocks.empty() || blocks.back().size() == blocks.back().capacity())
+            {
+                // size the block from the remaining encoded characters, when the URI continues past this span grow with the size decoded so far
+                size_t remaining = spanEnd > size ? spanEnd - size : 1;
+                size_t blockSize = lastSpan ? remaining : std::max(remaining, size);
+
+                blocks.emplace_back();
+                blocks.back().reserve(std::min(blockSize, maxBlockSize));
+            }
+            blocks.back().push_back(value);
+            ++size;
+        }
+
+        static uint32_t hex(char c)
+        {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            return 0x10000; // pushes the code point out of the ASCII range so it's skipped
+        }
+
+        /// decode the encoded characters in [ptr, end), last is true when the span ends at the URI's closing quote.
+        void decode(const char* ptr, const char* end, bool last)
+        {
+            spanEnd = size + (static_cast<size_t>(end - ptr) * 3) / 4 + 3;
+            lastSpan = last;
+
+            for(; ptr != end; ++ptr)
+            {
+                char c = *ptr;
+                if (escape == 1)
+                {
+                    // \uXXXX escape, or a single character escape such as \/ that is decoded as the escaped character
+                    escape = 0;
+                    if (c == 'u')
+                    {
+                        escape = 2;
+                        codePoint = 0;
+                        continue;
+                    }
+                }
+                else if (escape > 1)
+                {
+                    codePoint = (codePoint << 4) | hex(c);
+                    if (++escape < 6) continue;
+
+                    escape = 0;
+                    if (codePoint > 0x7f) continue;
+                    c = static_cast<char>(codePoint);
+                }
+                else if (c == '\\')
+                {
+                    escape = 1;
+                    continue;
+                }
+
+                // skip padding and white space
+                uint8_t value = lookup[static_cast<uint8_t>(c)];
+                if (value == 0xff) continue;
+
+                bits = (bits << 6) | value;
+                if (++numSextets == 4)
+                {
+                    push_back(static_cast<uint8_t>(bits >> 16));
+                    push_back(static_cast<uint8_t>(bits >> 8));
+                    push_back(static_cast<uint8_t>(bits));
+                    bits = 0;
+                    numSextets = 0;
+                }
+            }
+        }
+
+        vsg::ref_ptr<vsg::Data> finish()
+        {
+            // flush the 2 or 3 sextets left when the encoded data was padded.
+            if (numSextets == 2)
+            {
+                push_back(static_cast<uint8_t>(bits >> 4));
+            }
+            else if (numSextets == 3)
+            {
+                push_back(static_cast<uint8_t>(bits >> 10));
+                push_back(static_cast<uint8_t>(bits >> 2));
+            }
+
+            // vsg::Array sizes are 32 bit, so data URIs that decode to 4GB or more can't be held
+            vsg::ref_ptr<vsg::ubyteArray> data;
+            if (size <= std::numeric_limits<uint32_t>::max())
+            {
+                // copy the blocks into the final array, releasing each block once copied so peak memory stays close to the decoded size.
+                data = vsg::ubyteArray::create(static_cast<uint32_t>(size));
+                auto dest_itr = data->begin();
+                while(!blocks.empty())
+                {
+                    dest_itr = std::copy(blocks.front().begin(), blocks.front().end(), dest_itr);
+                    blocks.pop_front();
+                }
+            }
+            else
+            {
+                vsg::warn("gltf::read_streamed() data URI decodes to ", size, " bytes, exceeding the maximum array size.");
+                blocks.clear();
+            }
+
+            size = 0;
+            bits = 0;
+            numSextets = 0;
+            escape = 0;
+            return data;
+        }
+    };
+
+    enum State
+    {
+        OUTSIDE_STRING,
+        STRING_HEADER,
+        INSIDE_STRING,
+        STRING_ESCAPE,
+        BASE64_STRING
+    };
+
+    const std::string_view dataPrefix("data:");
+    const std::string_view base64Suffix(";base64,");
+    const size_t maxHeaderSize = 256;
+
+    State state = OUTSIDE_STRING;
+    std::string header;
+    std::string mimeType;
+    Base64Decoder decoder;
+    std::vector<char> chunk(chunkSize);
+
+    // only the values of "uri" properties are decoded, data URIs elsewhere such as in extras are passed through unchanged
+    size_t stringStart = 0; // position in buffer of the current string's first character
+    bool uriName = false; // the last string was "uri" and only white space and a colon have followed it
+    bool uriColon = false;
+    auto closeString = [&]()
+    {
+        uriName = std::string_view(buffer).substr(stringStart) == "uri";
+        uriColon = false;
+    };
+
+    while(fin)
+    {
+        fin.read(chunk.data(), chunk.size());
+        auto count = fin.gcount();
+        if (count <= 0) break;
+
+        const char* ptr = chunk.data();
+        const char* end = ptr + count;
+        while(ptr != end)
+        {
+            switch(state)
+            {
+                case(OUTSIDE_STRING):
+                {
+                    auto quote = std::find(ptr, end, '"');
+                    for(auto p = ptr; p != quote && uriName; ++p)
+                    {
+                        if (*p == ':' && !uriColon) uriColon = true;
+                        else if (*p != ' ' && *p != '\t' && *p != '\r' && *p != '\n') uriName = false;
+                    }
+
+                    buffer.append(ptr, quote);
+                    ptr = quote;
+                    if (ptr != end)
+                    {
+                        bool uriValue = uriName && uriColon;
+                        uriName = false;
+
+                        buffer.push_back(*ptr++);
+                        stringStart = buffer.size();
+                        header.clear();
+                        state = uriValue ? STRING_HEADER : INSIDE_STRING;
+                    }
+                    break;
+                }
+                case(STRING_HEADER):
+                {
+                    // collect the start of the string to check whether it's a base64 data URI
+                    char c = *ptr++;
+                    if (c == '"' || c == '\\')
+                    {
+                        buffer.append(header);
+                        if (c == '"') closeString();
+                        buffer.push_back(c);
+                        state = (c == '"') ? OUTSIDE_STRING : STRING_ESCAPE;
+                    }
+                    else
+                    {
+                        header.push_back(c);
+                        if (header.size() <= dataPrefix.size() && dataPrefix.compare(0, header.size(), header) != 0)
+                        {
+                            buffer.append(header);
+                            state = INSIDE_STRING;
+                        }
+                        else if (c == ',' && header.size() > (dataPrefix.size() + base64Suffix.size()) &&
+                                 header.compare(header.size() - base64Suffix.size(), base64Suffix.size(), base64Suffix) == 0)
+                        {
+                            mimeType = header.substr(dataPrefix.size(), header.size() - dataPrefix.size() - base64Suffix.size());
+                            state = BASE64_STRING;
+                        }
+                        else if (c == ',' || header.size() >= maxHeaderSize)
+                        {
+                            buffer.append(header);
+                            state = INSIDE_STRING;
+                        }
+                    }
+                    break;
+                }
+                case(INSIDE_STRING):
+                {
+                    auto special = std::find_if(ptr, end, [](char c) { return c == '"' || c == '\\'; });
+                    buffer.append(ptr, special);
+                    ptr = special;
+                    if (ptr != end)
+                    {
+                        if (*ptr == '"') closeString();
+                        state = (*ptr == '"') ? OUTSIDE_STRING : STRING_ESCAPE;
+                        buffer.push_back(*ptr++);
+                    }
+                    break;
+                }
+                case(STRING_ESCAPE):
+                {
+                    buffer.push_back(*ptr++);
+                    state = INSIDE_STRING;
+                    break;
+                }
+                case(BASE64_STRING):
+                {
+                    auto quote = std::find(ptr, end, '"');
+                    decoder.decode(ptr, quote, quote != end);
+                    ptr = quote;
+                    if (ptr != end && decoder.escape == 1)
+                    {
+                        // escaped quote, not part of the base64 data
+                        decoder.escape = 0;
+                        ++ptr;
+                    }
+                    else if (ptr != end)
+                    {
+                        buffer.append(vsg::make_string("data:", mimeType, ";streamed,", streamedData.size()));
+                        buffer.push_back(*ptr++);
+                        streamedData.push_back(decoder.finish());
+                        state = OUTSIDE_STRING;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    if (state != OUTSIDE_STRING)
+    {
+        vsg::warn("gltf::read_streamed() unterminated string at end of file.");
+        return false;
+    }
+
+    return !buffer.empty();
+}
@@ -23,10 +23,28 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 </editor-fold> */
 
+#include <vsg/core/observer_ptr.h>
 #include <vsg/io/ReaderWriter.h>
 #include <vsg/io/JSONParser.h>
+#include <vsg/maths/box.h>
+#include <vsg/maths/sphere.h>
+#include <vsg/nodes/VertexIndexDraw.h>
+#include <vsg/threading/OperationThreads.h>
 #include <vsg/utils/GraphicsPipelineConfigurator.h>
 
+#include <atomic>
+#include <charconv>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+
 namespace vsgXchange
 {
 
@@ -38,6 +56,8 @@ namespace vsgXchange
     public:
         gltf();
 
+        struct ExtensionRegistry;
+
         vsg::ref_ptr<vsg::Object> read(const vsg::Path&, vsg::ref_ptr<const vsg::Options>) const override;
         vsg::ref_ptr<vsg::Object> read(std::istream&, vsg::ref_ptr<const vsg::Options>) const override;
         vsg::ref_ptr<vsg::Object> read(const uint8_t* ptr, size_t size, vsg::ref_ptr<const vsg::Options> options = {}) const override;
@@ -46,12 +66,40 @@ namespace vsgXchange
 
         vsg::Logger::Level level = vsg::Logger::LOGGER_WARN;
 
+        /// extensions that are parsed into their own schema, unregistered extensions are retained as raw JSON.
+        vsg::ref_ptr<ExtensionRegistry> extensionRegistry;
+
         bool supportedExtension(const vsg::Path& ext) const;
 
         bool getFeatures(Features& features) const override;
 
         static constexpr const char* report = "report";
         static constexpr const char* culling = "culling"; /// bool, insert cull nodes, defaults to true
+        static constexpr const char* streaming = "streaming"; /// bool, read the file in chunks decoding base64 data URIs as they are read, defaults to false
+        static constexpr const char* compact_document = "compact_document"; /// bool, parse accessors, bufferViews and nodes into gltf::CompactDocument tables, defaults to false
+        static constexpr const char* query = "query"; /// bool, only parse the structure of the file and return a gltf::Summary rather than a scene graph, defaults to false
+        static constexpr const char* structural_index = "structural_index"; /// bool, build a gltf::StructuralIndex of the JSON before parsing, a validation and skipping aid that rejects malformed JSON up front and lets parallel_parse split arrays and the skipping of extensions, extras and animations jump over values. It doesn't speed up the parsing of the properties themselves so costs an extra pass for files that don't use those, defaults to false
+        static constexpr const char* parallel_parse = "parallel_parse"; /// bool, parse large accessors, bufferViews, nodes and meshes arrays on options->operationThreads, defaults to false
+        static constexpr const char* lazy_extras = "lazy_extras"; /// bool, keep extras as compacted JSON and only parse them on first access via gltf::LazyExtras, defaults to false
+        static constexpr const char* optimize_geometry = "optimize_geometry"; /// bool, narrow indices to uint16 where possible and reorder triangles and vertices of indexed triangle lists for the vertex cache, overdraw and vertex fetch, defaults to false
+        static constexpr const char* generate_indices = "generate_indices"; /// bool, weld the vertices of primitives without indices to generate indices, otherwise they are drawn with a vsg::VertexDraw, defaults to false
+        static constexpr const char* interleave_vertices = "interleave_vertices"; /// bool, pack the vertex attributes of each primitive into a single interleaved vertex buffer and binding, reusing the source layout when it's already interleaved, defaults to false
+        static constexpr const char* meshlets = "meshlets"; /// bool, split large indexed triangle lists into clusters culled individually against the view frustum and by normal cone, defaults to false
+        static constexpr const char* meshlet_vertices = "meshlet_vertices"; /// uint32_t, maximum number of vertices in a cluster, defaults to 64
+        static constexpr const char* meshlet_triangles = "meshlet_triangles"; /// uint32_t, maximum number of triangles in a cluster, defaults to 124
+        static constexpr const char* flatten_transforms = "flatten_transforms"; /// bool, bake static transforms into the vertices of meshes that aren't instanced and remove the transform nodes, defaults to false
+        static constexpr const char* batch_geometry = "batch_geometry"; /// bool, merge the static primitives of each scene that share a material into shared pre-transformed vertex and index arrays drawn together, defaults to false
+        static constexpr const char* simplify_graph = "simplify_graph"; /// bool, remove empty groups, collapse groups with a single child into their parents and merge sibling state groups with the same state, keeping nodes with names or extras, defaults to false
+        static constexpr const char* sort_state = "sort_state"; /// bool, order sibling state groups by pipeline, descriptor sets and vertex arrays and move the state shared by all the children of a group up into a parent StateGroup, defaults to false
+        static constexpr const char* share_content = "share_content"; /// bool, share images and buffers with the same contents, and samplers and materials with the same values, between all the files loaded with the same options->sharedObjects, defaults to false
+        static constexpr const char* max_texture_size = "max_texture_size"; /// uint32_t, halve the width and height of 8 bit RGB and RGBA images until neither exceeds this size, 0 for no limit, defaults to 0
+        static constexpr const char* texture_budget = "texture_budget"; /// uint32_t, MB of GPU memory for 8 bit RGB and RGBA images, halving the images with the most pixels for the bounds of the meshes using them until they fit, 0 for no budget, defaults to 0
+        static constexpr const char* prepare_images = "prepare_images"; /// bool, expand 8 bit RGB images to RGBA and generate their mipmaps on the operationThreads after decoding, rather than when compiling, defaults to false
+        static constexpr const char* mipmap_filter = "mipmap_filter"; /// std::string, filter used to generate the mipmaps of the prepare_images option, "box" or "kaiser", defaults to "box"
+        static constexpr const char* compress_images = "compress_images"; /// bool, encode 8 bit RGB and RGBA images to BC1, BC3, BC5 or BC7 on the operationThreads, implying prepare_images as their mipmaps can't be generated when compiled, caching the results in options->fileCache when it's set, defaults to false
+        static constexpr const char* compression_quality = "compression_quality"; /// std::string, quality of the compress_images option, "fast", "normal" or "high", defaults to "normal"
+        static constexpr const char* bc5_normals = "bc5_normals"; /// bool, encode normal maps to two channel BC5 with the compress_images option, for shaders that reconstruct z, otherwise they're encoded like other images, defaults to false
+        static constexpr const char* release_buffers = "release_buffers"; /// bool, copy the vertex, index and image data used by the scene graph into right-sized arrays so the glTF buffers can be released after load, defaults to false
 
         bool readOptions(vsg::Options& options, vsg::CommandLine& arguments) const override;
 
@@ -68,10 +116,158 @@ namespace vsgXchange
             explicit operator bool() const noexcept { return valid(); }
         };
 
+        /// longest number parse_value(input, value) collects, longer numbers fail. Doubles need at most 17 significant digits so this only rejects
+        /// numbers padded with leading or trailing zeros.
+        static constexpr size_t max_number_length = 128;
+
+        /// parse the number at the start of [first, last) using std::from_chars, avoiding the locale and sentry overhead of operator>>.
+        /// The number's characters are all consumed, and integers written with a fraction or exponent such as 1.0 or 1e3 are accepted
+        /// when their value is a whole number within range. Returns the end of the number's characters, setting valid to false on failure
+        /// in which case value is unchanged.
+        template<typename T>
+        static const char* parse_number(const char* first, const char* last, T& value, bool& valid)
+        {
+            const char* end = first;
+            for(; end != last; ++end)
+            {
+                char c = *end;
+                if (!((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')) break;
+            }
+
+            T parsed{};
+            auto result = std::from_chars(first, end, parsed);
+            if (result.ec == std::errc() && result.ptr == end)
+            {
+                value = parsed;
+                valid = true;
+                return end;
+            }
+
+            if constexpr (std::is_integral_v<T>)
+            {
+                double d = 0.0;
+                auto dresult = std::from_chars(first, end, d);
+                if (dresult.ec == std::errc() && dresult.ptr == end && std::trunc(d) == d &&
+                    d >= static_cast<double>(std::numeric_limits<T>::min()) && d <= static_cast<double>(std::numeric_limits<T>::max()))
+                {
+                    value = static_cast<T>(d);
+                    valid = true;
+                    return end;
+                }
+            }
+
+            valid = false;
+            return end;
+        }
+
+        /// parse a number from the stream with parse_number(..), collecting its characters into a stack buffer of max_number_length.
+        /// Used when the number isn't in a JSONParser's buffer. Sets failbit and returns false on failure.
+        template<typename T>
+        static bool parse_value(std::istream& input, T& value)
+        {
+            char str[max_number_length];
+            size_t length = 0;
+            bool overflow = false;
+
+            auto buffer = input.rdbuf();
+            for(auto c = buffer->sgetc(); c != std::char_traits<char>::eof(); c = buffer->snextc())
+            {
+                if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E')
+                {
+                    if (length < max_number_length) str[length++] = static_cast<char>(c);
+                    else overflow = true; // keep consuming so the stream is left after the number
+                }
+                else break;
+            }
+
+            bool valid = false;
+            if (!overflow) parse_number(str, str + length, value, valid);
+            if (!valid) input.setstate(std::ios::failbit);
+            return valid;
+        }
+
+        static bool parse_value(std::istream& input, glTFid& id) { return parse_value(input, id.value); }
+
+        /// read a number with parse_number(..) directly from the parser's buffer, advancing input past it, reporting a failure to the parser.
+        /// The JSONParser passes numbers as a stream over its buffer starting at parser.pos, if input isn't positioned there parse_value(..) is used.
+        template<typename T>
+        static bool read_value(vsg::JSONParser& parser, std::istream& input, T& value)
+        {
+            bool valid = false;
+
+            auto streambuf = input.rdbuf();
+            auto offset = streambuf->pubseekoff(0, std::ios::cur, std::ios::in);
+            size_t position = parser.pos + static_cast<size_t>(offset);
+            if (offset != std::streampos(-1) && position < parser.buffer.size() && streambuf->sgetc() == parser.buffer[position])
+            {
+                const char* first = parser.buffer.data() + position;
+                const char* end = parse_number(first, parser.buffer.data() + parser.buffer.size(), value, valid);
+                streambuf->pubseekoff(end - first, std::ios::cur, std::ios::in);
+                if (!valid) input.setstate(std::ios::failbit);
+            }
+            else
+            {
+                valid = parse_value(input, value);
+            }
+
+            if (!valid) parser.warning();
+            return valid;
+        }
+
+        static bool read_value(vsg::JSONParser& parser, std::istream& input, glTFid& id) { return read_value(parser, input, id.value); }
+
+        /// ValuesSchema that reads its numbers using read_value(..)
+        template<typename T>
+        struct NumberValues : public vsg::ValuesSchema<T>
+        {
+            void read_number(vsg::JSONParser& parser, std::istream& input) override
+            {
+                T value{};
+                if (read_value(parser, input, value)) this->values.push_back(value);
+            }
+        };
+
+
+        /// registry of supported extensions, mapping extension names to compact ids and the factories used to create their schemas.
+        struct ExtensionRegistry : public vsg::Inherit<vsg::Object, ExtensionRegistry>
+        {
+            static constexpr uint32_t invalid_id = std::numeric_limits<uint32_t>::max();
+
+            /// key used to assign the ExtensionRegistry to the JSONParser
+            static const std::string key;
+
+            using Factory = vsg::ref_ptr<vsg::JSONParser::Schema> (*)();
+
+            struct Entry
+            {
+                std::string name;
+                Factory create = nullptr;
+            };
+
+            std::vector<Entry> entries;
+
+            template<class T>
+            uint32_t add(const std::string& name)
+            {
+                entries.push_back(Entry{name, []() -> vsg::ref_ptr<vsg::JSONParser::Schema> { return T::create(); }});
+                return static_cast<uint32_t>(entries.size() - 1);
+            }
+
+            /// return the id of the named extension, or invalid_id if it's not registered.
+            uint32_t id(const std::string_view& name) const;
+        };
 
         struct Extensions : public vsg::Inherit<vsg::JSONtoMetaDataSchema, Extensions>
         {
-            std::map<std::string, vsg::ref_ptr<vsg::JSONParser::Schema>> values;
+            struct Extension
+            {
+                std::string_view name; // view into the parser buffer, valid for the duration of the load
+                uint32_t id = ExtensionRegistry::invalid_id;
+                vsg::ref_ptr<vsg::JSONParser::Schema> schema; // schema of registered extensions
+                std::string_view json; // raw JSON of unregistered extensions, view into the parser buffer
+            };
+
+            std::vector<Extension> values;
 
             void report();
 
@@ -80,23 +276,67 @@ namespace vsgXchange
 
         using Extras = vsg::JSONtoMetaDataSchema;
 
+        /// extras retained as compacted JSON text and only parsed into a vsg::Object tree when first accessed, used when the gltf::lazy_extras option is set.
+        /// Assigned to scene graph objects as their "extras" object, use gltf::extras(object) to access the materialised extras.
+        class LazyExtras : public vsg::Inherit<vsg::Object, LazyExtras>
+        {
+        public:
+            /// key used to enable lazy extras on the JSONParser
+            static const std::string key;
+
+            LazyExtras() {}
+            explicit LazyExtras(const std::string_view& in_json);
+
+            /// JSON with the white space outside of strings removed
+            std::string json;
+
+            /// return the extras, parsing the JSON on the first call. Thread safe.
+            vsg::ref_ptr<vsg::Object> object();
+
+            void read(vsg::Input& input) override;
+            void write(vsg::Output& output) const override;
+
+        protected:
+            std::mutex _mutex;
+            vsg::ref_ptr<vsg::Object> _object;
+        };
+
+        /// return the "extras" object assigned to object, materialising it first if it's a LazyExtras.
+        static vsg::ref_ptr<vsg::Object> extras(vsg::Object& object);
+
         struct ExtensionsExtras : public vsg::Inherit<vsg::JSONParser::Schema, ExtensionsExtras>
         {
             vsg::ref_ptr<Extensions> extensions;
             vsg::ref_ptr<Extras> extras;
+            vsg::ref_ptr<LazyExtras> lazyExtras;
 
             void report();
 
             void read_object(vsg::JSONParser& parser, const std::string_view& property) override;
 
             template<class T>
-            vsg::ref_ptr<T> extension(const char* name) const
+            vsg::ref_ptr<T> extension(const std::string_view& name) const
             {
                 if (!extensions) return {};
 
-                auto itr = extensions->values.find(name);
-                if (itr != extensions->values.end()) return itr->second.cast<T>();
-                else return {};
+                for(auto& value : extensions->values)
+                {
+                    if (value.name == name) return value.schema.cast<T>();
+                }
+                return {};
+            }
+
+            /// return the registered extension with the ExtensionRegistry id, resolve ids once per load with ExtensionRegistry::id(name).
+            template<class T>
+            vsg::ref_ptr<T> extension(uint32_t id) const
+            {
+                if (!extensions || id == ExtensionRegistry::invalid_id) return {};
+
+                for(auto& value : extensions->values)
+                {
+                    if (value.id == id) return value.schema.cast<T>();
+                }
+                return {};
             }
         };
 
@@ -147,10 +387,14 @@ namespace vsgXchange
             bool normalized = false;
             uint32_t count = 0;
             std::string type;
-            vsg::ValuesSchema<double> max;
-            vsg::ValuesSchema<double> min;
+            NumberValues<double> max;
+            NumberValues<double> min;
             vsg::ref_ptr<Sparse> sparse;
 
+            // JSON of max and min retained in place of their values by a structure only parse, views into the parser buffer
+            std::string_view maxJSON;
+            std::string_view minJSON;
+
             void report();
             void read_array(vsg::JSONParser& parser, const std::string_view& property) override;
             void read_string(vsg::JSONParser& parser, const std::string_view& property) override;
@@ -175,7 +419,7 @@ namespace vsgXchange
             glTFid buffer;
             uint32_t byteOffset = 0;
             uint32_t byteLength = 0;
-            uint32_t byteStride = 4;
+            uint32_t byteStride = 0;
             uint32_t target = 0;
 
             void report();
@@ -219,7 +463,7 @@ namespace vsgXchange
 
         struct PbrMetallicRoughness : public vsg::Inherit<ExtensionsExtras, PbrMetallicRoughness>
         {
-            vsg::ValuesSchema<double> baseColorFactor; // default { 1.0, 1.0, 1.0, 1.0 }
+            NumberValues<double> baseColorFactor; // default { 1.0, 1.0, 1.0, 1.0 }
             TextureInfo baseColorTexture;
             double metallicFactor = 1.0;
             double roughnessFactor = 1.0;
@@ -249,12 +493,9 @@ namespace vsgXchange
         {
             double specularFactor = 1.0;
             TextureInfo specularTexture;
-            vsg::ValuesSchema<double> specularColorFactor;
+            NumberValues<double> specularColorFactor;
             TextureInfo specularColorTexture;
 
-            // extention prototype will be cloned when it's used.
-            vsg::ref_ptr<vsg::Object> clone(const vsg::CopyOp&) const override { return KHR_materials_specular::create(*this); }
-
             void read_array(vsg::JSONParser& parser, const std::string_view& property) override;
             void read_object(vsg::JSONParser& parser, const std::string_view& property) override;
             void read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input) override;
@@ -265,9 +506,6 @@ namespace vsgXchange
         {
             double ior = 1.5;
 
-            // extention prototype will be cloned when it's used.
-            vsg::ref_ptr<vsg::Object> clone(const vsg::CopyOp&) const override { return KHR_materials_ior::create(*this); }
-
             void read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input) override;
         };
 
@@ -313,7 +551,7 @@ namespace vsgXchange
             NormalTextureInfo normalTexture;
             OcclusionTextureInfo occlusionTexture;
             TextureInfo emissiveTexture;
-            vsg::ValuesSchema<double> emissiveFactor; // default { 0.0, 0.0, 0.0 }
+            NumberValues<double> emissiveFactor; // default { 0.0, 0.0, 0.0 }
             std::string alphaMode = "OPAQUE";
             double alphaCutoff = 0.5;
             bool doubleSided = false;
@@ -351,7 +589,7 @@ namespace vsgXchange
         struct Mesh : public vsg::Inherit<NameExtensionsExtras, Mesh>
         {
             vsg::ObjectsSchema<Primitive> primitives;
-            vsg::ValuesSchema<double> weights;
+            NumberValues<double> weights;
 
             void report();
             void read_array(vsg::JSONParser& parser, const std::string_view& property) override;
@@ -362,12 +600,12 @@ namespace vsgXchange
             glTFid camera;
             glTFid skin;
             glTFid mesh;
-            vsg::ValuesSchema<glTFid> children;
-            vsg::ValuesSchema<double> matrix;
-            vsg::ValuesSchema<double> rotation;
-            vsg::ValuesSchema<double> scale;
-            vsg::ValuesSchema<double> translation;
-            vsg::ValuesSchema<double> weights;
+            NumberValues<glTFid> children;
+            NumberValues<double> matrix;
+            NumberValues<double> rotation;
+            NumberValues<double> scale;
+            NumberValues<double> translation;
+            NumberValues<double> weights;
 
             void report();
             void read_array(vsg::JSONParser& parser, const std::string_view& property) override;
@@ -377,7 +615,7 @@ namespace vsgXchange
 
         struct Scene : public vsg::Inherit<NameExtensionsExtras, Scene>
         {
-            vsg::ValuesSchema<glTFid> nodes;
+            NumberValues<glTFid> nodes;
 
             void report();
             void read_array(vsg::JSONParser& parser, const std::string_view& property) override;
@@ -457,13 +695,213 @@ namespace vsgXchange
         {
             glTFid inverseBindMatrices;
             glTFid skeleton;
-            vsg::ValuesSchema<glTFid> joints;
+            NumberValues<glTFid> joints;
 
             void report();
             void read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input) override;
             void read_array(vsg::JSONParser& parser, const std::string_view& property) override;
         };
 
+        /// bump allocator handing out memory from large blocks, all the memory is released in one go when the Arena is destroyed.
+        class Arena
+        {
+        public:
+            explicit Arena(size_t in_blockSize = 65536) : blockSize(in_blockSize) {}
+            Arena(const Arena&) = delete;
+            Arena& operator=(const Arena&) = delete;
+
+            void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+            /// copy the string into the arena, returning a view of the copy.
+            std::string_view copy(const std::string_view& str);
+
+            size_t allocated() const { return totalAllocated; }
+
+        protected:
+            size_t blockSize;
+            size_t totalAllocated = 0;
+            std::vector<std::unique_ptr<uint8_t[]>> blocks;
+            uint8_t* ptr = nullptr;
+            uint8_t* end = nullptr;
+        };
+
+        /// compact, index based representation of the accessors, bufferViews and nodes, used in place of the per element
+        /// Accessor, BufferView and Node objects when the gltf::compact_document option is set.
+        /// Properties are held in per property columns, names are interned into an Arena, and variable length arrays are held
+        /// in shared pools, so parsing files with hundreds of thousands of elements doesn't require an allocation per element.
+        struct CompactDocument : public vsg::Inherit<vsg::Object, CompactDocument>
+        {
+            static constexpr uint32_t invalid_id = std::numeric_limits<uint32_t>::max();
+
+            /// range of values within one of the doubles or ids pools
+            struct Range
+            {
+                uint32_t offset = 0;
+                uint32_t count = 0;
+            };
+
+            struct Accessors
+            {
+                std::vector<glTFid> bufferView;
+                std::vector<uint32_t> byteOffset;
+                std::vector<uint32_t> componentType;
+                std::vector<uint8_t> normalized;
+                std::vector<uint32_t> count;
+                std::vector<uint32_t> type; // interned string
+                std::vector<Range> min;
+                std::vector<Range> max;
+                std::vector<uint32_t> name; // interned string
+                std::vector<uint32_t> extensionsExtras; // index into CompactDocument::extensionsExtras
+
+                size_t size() const { return bufferView.size(); }
+                void push_back();
+            };
+
+            struct BufferViews
+            {
+                std::vector<glTFid> buffer;
+                std::vector<uint32_t> byteOffset;
+                std::vector<uint32_t> byteLength;
+                std::vector<uint32_t> byteStride;
+                std::vector<uint32_t> target;
+                std::vector<uint32_t> name; // interned string
+                std::vector<uint32_t> extensionsExtras; // index into CompactDocument::extensionsExtras
+
+                size_t size() const { return buffer.size(); }
+                void push_back();
+            };
+
+            struct Nodes
+            {
+                std::vector<glTFid> camera;
+                std::vector<glTFid> skin;
+                std::vector<glTFid> mesh;
+                std::vector<Range> children;
+                std::vector<Range> matrix;
+                std::vector<Range> rotation;
+                std::vector<Range> scale;
+                std::vector<Range> translation;
+                std::vector<Range> weights;
+                std::vector<uint32_t> name; // interned string
+                std::vector<uint32_t> extensionsExtras; // index into CompactDocument::extensionsExtras
+
+                size_t size() const { return camera.size(); }
+                void push_back();
+            };
+
+            Accessors accessors;
+            BufferViews bufferViews;
+            Nodes nodes;
+
+            // pools for the variable length arrays
+            std::vector<double> doubles;
+            std::vector<glTFid> ids;
+
+            // extensions and extras are rare so are only allocated for the elements that have them
+            std::vector<vsg::ref_ptr<NameExtensionsExtras>> extensionsExtras;
+
+            // interned strings
+            Arena arena;
+            std::vector<std::string_view> strings;
+            std::unordered_map<std::string_view, uint32_t> stringLookup;
+
+            uint32_t intern(const std::string_view& str);
+            std::string_view string(uint32_t id) const { return id < strings.size() ? strings[id] : std::string_view{}; }
+
+            const double* values(const Range& range) const { return doubles.data() + range.offset; }
+            const glTFid* children(uint32_t node) const { return ids.data() + nodes.children[node].offset; }
+
+            void report();
+
+            /// schema that appends the elements of the accessors array to CompactDocument::accessors
+            struct AccessorsSchema : public vsg::Inherit<vsg::JSONParser::Schema, AccessorsSchema>
+            {
+                CompactDocument* document = nullptr;
+
+                void read_object(vsg::JSONParser& parser) override;
+                void read_array(vsg::JSONParser& parser, const std::string_view& property) override;
+                void read_object(vsg::JSONParser& parser, const std::string_view& property) override;
+                void read_string(vsg::JSONParser& parser, const std::string_view& property) override;
+                void read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input) override;
+                void read_bool(vsg::JSONParser& parser, const std::string_view& property, bool value) override;
+            };
+
+            /// schema that appends the elements of the bufferViews array to CompactDocument::bufferViews
+            struct BufferViewsSchema : public vsg::Inherit<vsg::JSONParser::Schema, BufferViewsSchema>
+            {
+                CompactDocument* document = nullptr;
+
+                void read_object(vsg::JSONParser& parser) override;
+                void read_object(vsg::JSONParser& parser, const std::string_view& property) override;
+                void read_string(vsg::JSONParser& parser, const std::string_view& property) override;
+                void read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input) override;
+            };
+
+            /// schema that appends the elements of the nodes array to CompactDocument::nodes
+            struct NodesSchema : public vsg::Inherit<vsg::JSONParser::Schema, NodesSchema>
+            {
+                CompactDocument* document = nullptr;
+
+                void read_object(vsg::JSONParser& parser) override;
+                void read_array(vsg::JSONParser& parser, const std::string_view& property) override;
+                void read_object(vsg::JSONParser& parser, const std::string_view& property) override;
+                void read_string(vsg::JSONParser& parser, const std::string_view& property) override;
+                void read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input) override;
+            };
+
+            // helpers used by the schemas
+            Range read_doubles(vsg::JSONParser& parser);
+            Range read_ids(vsg::JSONParser& parser);
+            uint32_t read_string(vsg::JSONParser& parser);
+            void read_extensionsExtras(vsg::JSONParser& parser, const std::string_view& property, uint32_t& index);
+
+        protected:
+            NumberValues<double> doublesSchema;
+            NumberValues<glTFid> idsSchema;
+            std::string str;
+        };
+
+        /// lightweight summary of a glTF file returned in place of a scene graph when the gltf::query option is set,
+        /// created from the parsed JSON alone so no buffers or images are read and no scene graph is built.
+        struct Summary : public vsg::Inherit<vsg::Object, Summary>
+        {
+            /// key used to flag a structure only parse on the JSONParser, skipping the extensions, extras, animations and bulk arrays not required by the summary
+            static const std::string key;
+
+            std::string version;
+            std::string generator;
+
+            uint32_t numAccessors = 0;
+            uint32_t numBufferViews = 0;
+            uint32_t numBuffers = 0;
+            uint32_t numImages = 0;
+            uint32_t numTextures = 0;
+            uint32_t numMaterials = 0;
+            uint32_t numMeshes = 0;
+            uint32_t numPrimitives = 0;
+            uint32_t numNodes = 0;
+            uint32_t numScenes = 0;
+            uint32_t numAnimations = 0;
+            uint32_t numCameras = 0;
+            uint32_t numSkins = 0;
+
+            std::vector<std::string> nodeNames;
+            std::vector<std::string> meshNames;
+            std::vector<std::string> materialNames;
+
+            std::vector<std::string> extensionsUsed;
+            std::vector<std::string> extensionsRequired;
+
+            /// bounds of the default scene computed from the POSITION accessor min/max values and the node transforms,
+            /// in the options->sceneCoordinateConvention used by the SceneGraphBuilder.
+            vsg::dbox bounds;
+
+            void read(vsg::Input& input) override;
+            void write(vsg::Output& output) const override;
+
+            void report();
+        };
+
         struct glTF : public vsg::Inherit<ExtensionsExtras, glTF>
         {
             vsg::ValuesSchema<std::string> extensionsUsed;
@@ -484,6 +922,26 @@ namespace vsgXchange
             vsg::ObjectsSchema<Camera> cameras;
             vsg::ObjectsSchema<Skins> skins;
 
+            // registry the extensions were parsed with, used to resolve the ids of Extensions::Extension
+            vsg::ref_ptr<const ExtensionRegistry> extensionRegistry;
+
+            // data URIs decoded by gltf::read_streamed(..), referenced by "data:<mimeType>;streamed,<index>" uris
+            std::vector<vsg::ref_ptr<vsg::Data>> streamedData;
+
+            // when assigned the accessors, bufferViews and nodes are read into the compact tables rather than the ObjectsSchema above
+            vsg::ref_ptr<CompactDocument> compact;
+
+            // when true only the elements required by createSummary() are parsed, animations, extensions, extras, morph targets, weights,
+            // joints and sparse accessors are skipped over, and accessor min/max are retained as JSON, see gltf::Summary::key
+            bool structureOnly = false;
+
+            // when assigned large accessors, bufferViews, nodes and meshes arrays are parsed in parallel, see gltf::parallel_parse
+            vsg::ref_ptr<vsg::OperationThreads> operationThreads;
+            size_t minimumParallelElements = 1024;
+
+            // parsers used by the parallel parse, kept for the lifetime of the glTF as string_views reference their buffers
+            std::list<vsg::JSONParser> parsers;
+
             void read_array(vsg::JSONParser& parser, const std::string_view& property) override;
             void read_object(vsg::JSONParser& parser, const std::string_view& property) override;
             void read_number(vsg::JSONParser& parser, const std::string_view& property, std::istream& input) override;
@@ -492,9 +950,239 @@ namespace vsgXchange
 
             virtual void resolveURIs(vsg::ref_ptr<const vsg::Options> options);
 
+            virtual vsg::ref_ptr<Summary> createSummary(vsg::ref_ptr<const vsg::Options> options);
+
+        };
+
+
+        /// load time optimization of indexed triangle lists: narrowing of the indices to uint16 where the vertex count allows, reordering of the triangles
+        /// for the post-transform vertex cache using Tom Forsyth's linear-speed vertex cache optimization, sorting clusters of triangles so that outward
+        /// facing ones further from the centre are drawn first to reduce overdraw, and reordering of the vertices into first-use order for vertex fetch.
+        struct GeometryOptimizer
+        {
+            uint32_t cacheSize = 32; // size of the LRU cache modelled by the Forsyth scoring
+            uint32_t fifoSize = 16; // size of the FIFO cache used to compute cache misses and ACMR
+            float overdrawThreshold = 1.05f; // how much the ACMR of a cluster may exceed that of the vertex cache order when splitting into clusters for overdraw sorting
+            bool narrowIndices = true;
+            bool vertexCache = true;
+            bool overdraw = true;
+            bool vertexFetch = true;
+
+            struct Statistics
+            {
+                size_t numPrimitives = 0;
+                size_t numNarrowed = 0;
+                size_t numTriangles = 0;
+                size_t missesBefore = 0;
+                size_t missesAfter = 0;
+
+                double acmrBefore() const { return numTriangles > 0 ? static_cast<double>(missesBefore) / static_cast<double>(numTriangles) : 0.0; }
+                double acmrAfter() const { return numTriangles > 0 ? static_cast<double>(missesAfter) / static_cast<double>(numTriangles) : 0.0; }
+
+                Statistics& operator+=(const Statistics& rhs);
+            };
+
+            /// optimize the indices of a VertexIndexDraw of a triangle list, and when reorderVertices is true and all its per vertex arrays have the
+            /// same count, assign it permuted copies of them. positions are used for overdraw sorting, which is skipped if null. Returns false if
+            /// the indices couldn't be optimized.
+            bool optimize(vsg::VertexIndexDraw& vid, const vsg::vec3Array* positions, bool reorderVertices, Statistics& statistics) const;
+
+            /// number of vertex transforms required to draw the triangles with a FIFO post-transform cache of fifoSize entries.
+            static size_t cacheMisses(const std::vector<uint32_t>& indices, size_t numVertices, uint32_t fifoSize);
+
+            /// reorder the triangles to improve post-transform vertex cache hits.
+            static void optimizeVertexCache(std::vector<uint32_t>& indices, size_t numVertices, uint32_t cacheSize);
+
+            /// split the triangles into clusters at cache boundaries and sort the clusters to reduce overdraw, preserving the vertex cache order within clusters.
+            static void optimizeOverdraw(std::vector<uint32_t>& indices, const std::vector<vsg::vec3>& positions, uint32_t fifoSize, float threshold);
+
+            /// renumber the vertices in the order they are first used by the indices, returning the remap from old to new vertex index.
+            static std::vector<uint32_t> optimizeVertexFetch(std::vector<uint32_t>& indices, size_t numVertices);
+
+            /// copy ubyte, ushort or uint indices into indices, returning false for other types.
+            static bool readIndices(const vsg::Data& data, std::vector<uint32_t>& indices);
+        };
+
+        /// generate indices for primitives without them by merging vertices whose attributes are all identical, compacting the vertex arrays to the unique vertices.
+        /// Vertices are hashed over all their attributes, partitioned into buckets by hash and each bucket deduplicated with an open addressing hash table,
+        /// with the hashing, bucketing, deduplication and copying each distributed across the operationThreads.
+        struct VertexWelder
+        {
+            uint32_t minParallelVertices = 65536; // fewer vertices are welded on the calling thread
+            uint32_t verticesPerChunk = 65536;
+            uint32_t numBuckets = 256;
+
+            struct Result
+            {
+                vsg::DataList arrays; // arrays with a value per vertex compacted to the unique vertices keeping their stride, others passed through unchanged
+                vsg::ref_ptr<vsg::Data> indices;
+                uint32_t numVertices = 0; // number of unique vertices
+            };
+
+            /// return true if there are vertices to weld, numVertices is non zero and at least one of the arrays has a value per vertex.
+            static bool weldable(const vsg::DataList& arrays, uint32_t numVertices);
+
+            /// weld the numVertices vertices of arrays. If any per vertex array is of an unsupported type the arrays are returned unchanged with sequential indices,
+            /// if the arrays aren't weldable(..) no indices are returned.
+            Result weld(const vsg::DataList& arrays, uint32_t numVertices, vsg::ref_ptr<vsg::OperationThreads> operationThreads) const;
+        };
+
+        /// node culling its child, the draw of a cluster of triangles, when its bounding sphere is outside the view frustum or when all of its triangles
+        /// face away from the eye, tested using a cone bounding the triangle normals.
+        class ClusterCullNode : public vsg::Inherit<vsg::Node, ClusterCullNode>
+        {
+        public:
+            vsg::dsphere bound;
+            vsg::vec3 coneAxis;
+            float coneCutoff = 1.0f; // sine of the angle between the cone axis and the most divergent normal, 1.0 disables back face culling
+            uint32_t numTriangles = 0;
+            vsg::ref_ptr<vsg::Node> child;
+
+            /// return true if all the triangles face away from an eye at the origin of the modelview's coordinate frame.
+            bool backFacing(const vsg::dmat4& modelview) const;
+
+            void traverse(vsg::Visitor& visitor) override { if (child) child->accept(visitor); }
+            void traverse(vsg::ConstVisitor& visitor) const override { if (child) child->accept(visitor); }
+            void traverse(vsg::RecordTraversal& visitor) const override;
+
+            void read(vsg::Input& input) override;
+            void write(vsg::Output& output) const override;
+        };
+
+        /// split large indexed triangle lists into clusters of at most maxVertices vertices and maxTriangles triangles, each drawn by a DrawIndexed
+        /// under a ClusterCullNode, with the vertex arrays and indices bound once for all the clusters. Clusters are made from consecutive triangles
+        /// so are most compact when the triangles are in vertex cache order, see gltf::optimize_geometry.
+        struct ClusterBuilder
+        {
+            uint32_t maxVertices = 64;
+            uint32_t maxTriangles = 124;
+            uint32_t minTriangles = 1024; // primitives with fewer triangles are left as a single draw
+
+            struct Cluster
+            {
+                uint32_t firstIndex = 0;
+                uint32_t indexCount = 0;
+                vsg::dsphere bound;
+                vsg::vec3 coneAxis;
+                float coneCutoff = 1.0f;
+            };
+
+            /// split the triangles into clusters, computing their bounds and, if backFaceCulling is true, their normal cones.
+            std::vector<Cluster> build(const std::vector<uint32_t>& indices, const std::vector<vsg::vec3>& positions, bool backFaceCulling) const;
+
+            /// return a Group binding the vid's arrays and indices followed by a ClusterCullNode per cluster, or null if the vid has too few triangles.
+            vsg::ref_ptr<vsg::Node> createClusters(const vsg::VertexIndexDraw& vid, const vsg::vec3Array& positions, bool backFaceCulling) const;
         };
 
+        /// merge primitives drawn with the same state into a VertexIndexDraw with shared vertex and index arrays, pre-transforming
+        /// the positions and normals of each primitive by the matrix of the transforms above it.
+        struct GeometryBatcher
+        {
+            uint32_t maxPrimitiveVertices = 65536; // larger primitives are left to draw on their own rather than being copied for each instance
+            uint32_t maxBatchVertices = 1048576;
+
+            struct Primitive
+            {
+                vsg::ref_ptr<vsg::Command> draw; // VertexIndexDraw or VertexDraw
+                vsg::dmat4 matrix;
+                int positionArray = -1;
+                int normalArray = -1;
+                bool triangles = false;
+            };
+
+            /// return a signature of the primitive's arrays that is the same for all the primitives it can be merged with,
+            /// or an empty string if it can't be batched.
+            std::string layout(const Primitive& primitive) const;
 
+            /// merge primitives with the same layout, the total number of vertices should be within maxBatchVertices.
+            vsg::ref_ptr<vsg::VertexIndexDraw> merge(const std::vector<Primitive>& primitives) const;
+
+            static uint32_t numVertices(const Primitive& primitive);
+        };
+
+        /// bake matrices into the vertices of primitives, with the matrix-vector products done 4 floats at a time using SSE2 where available.
+        struct TransformFlattener
+        {
+            /// return true if bake(..) can transform the primitive by matrix.
+            static bool bakeable(const GeometryBatcher::Primitive& primitive, const vsg::dmat4& matrix);
+
+            /// assign copies of the primitive's positions and normals transformed by matrix to its draw, along with indices of
+            /// reversed winding if the matrix mirrors the triangles.
+            static void bake(const GeometryBatcher::Primitive& primitive, const vsg::dmat4& matrix);
+
+            static void transformPositions(const vsg::dmat4& matrix, const vsg::vec3Array& positions, vsg::vec3Array& result);
+            static void transformNormals(const vsg::dmat4& matrix, const vsg::vec3Array& normals, vsg::vec3Array& result);
+        };
+
+        /// convert decoded 8 bit RGB and RGBA images to RGBA with a full mipmap chain generated on the CPU, so the compile traversal copies the
+        /// images to the GPU rather than converting them and generating the mipmaps with blits. RGB is expanded to RGBA 4 pixels at a time using
+        /// SSSE3 where available, and the mipmaps are resampled from the previous level in linear space, decoding sRGB images first.
+        struct ImagePreparer
+        {
+            enum Filter
+            {
+                BOX,   // average the 2x2 pixels covered by each pixel of the next level
+                KAISER // Kaiser windowed sinc over 3 pixels of the next level either side, sharper than box with less aliasing
+            };
+
+            Filter filter = BOX;
+
+            /// return true if the image is a 2D 8 bit RGB or RGBA image without mipmaps, as prepared and downscaled.
+            static bool supported(const vsg::Data& image);
+
+            /// return the image converted to RGBA with mipmaps, or the image unchanged if it isn't supported.
+            vsg::ref_ptr<vsg::Data> prepare(vsg::ref_ptr<vsg::Data> image) const;
+
+            /// return the image resampled to width x height with the Kaiser filter, keeping its format, or the image unchanged if it's no larger
+            /// or isn't supported.
+            static vsg::ref_ptr<vsg::Data> downscale(vsg::ref_ptr<vsg::Data> image, uint32_t width, uint32_t height);
+
+            /// copy numPixels RGB pixels from src to RGBA pixels in dest with alpha of 255.
+            static void expandRGB(const uint8_t* src, uint8_t* dest, size_t numPixels);
+        };
+
+        /// encode 8 bit RGB and RGBA images, including their mipmaps, to block compressed formats: opaque images to BC1, images with alpha to BC7,
+        /// or BC3 for FAST quality, and normal maps to two channel BC5 when bc5Normals is set. The end points of each block are fitted to its bounding
+        /// box for FAST quality and to its principal axis for NORMAL, then refined by least squares for NORMAL and HIGH quality. When cacheDirectory
+        /// is set the results are written to it as .vsgb files keyed by a hash of the image and settings, so later loads read them rather than encoding.
+        struct BlockCompressor
+        {
+            enum Quality
+            {
+                FAST,
+                NORMAL,
+                HIGH
+            };
+
+            enum Usage
+            {
+                COLOR,
+                NORMAL_MAP
+            };
+
+            Quality quality = NORMAL;
+            bool bc5Normals = false; // the shader must reconstruct the z of the normals from x and y
+            vsg::Path cacheDirectory;
+
+            struct Result
+            {
+                vsg::ref_ptr<vsg::Data> image;
+                bool cached = false; // image was read from the cacheDirectory
+            };
+
+            /// return the compressed image, or the image unchanged if it isn't a 2D 8 bit RGB or RGBA image with dimensions that are multiples of 4
+            /// and mipmaps that map onto whole blocks.
+            Result compress(vsg::ref_ptr<vsg::Data> image, Usage usage, vsg::ref_ptr<const vsg::Options> options) const;
+
+            /// encode the 4x4 block of RGBA pixels at rgba, in rows, to the 8 or 16 bytes at block.
+            static void encodeBC1(const uint8_t* rgba, Quality quality, uint8_t* block);
+            static void encodeBC3(const uint8_t* rgba, Quality quality, uint8_t* block);
+            static void encodeBC5(const uint8_t* rgba, Quality quality, uint8_t* block);
+            static void encodeBC7(const uint8_t* rgba, Quality quality, uint8_t* block);
+        };
+
+        /// SceneGraphBuilder holds the state of a single load so isn't thread safe, gltf::_read(..) creates one per load
+        /// so concurrent reads are safe, with state shared between loads only accessed via the thread safe vsg::SharedObjects.
         class SceneGraphBuilder : public vsg::Inherit<vsg::Object, SceneGraphBuilder>
         {
         public:
@@ -510,6 +1198,79 @@ namespace vsgXchange
             vsg::ref_ptr<vsg::ShaderSet> shaderSet;
             vsg::ref_ptr<vsg::SharedObjects> sharedObjects;
 
+            // ExtensionRegistry ids of the extensions queried when building, resolved by createSceneGraph(..) from the glTF's extensionRegistry
+            uint32_t KHR_materials_specular_id = ExtensionRegistry::invalid_id;
+            uint32_t KHR_materials_ior_id = ExtensionRegistry::invalid_id;
+
+            // indexed triangle lists collected by createMesh(..) for optimization once all the meshes have been created
+            struct OptimizableTriangles
+            {
+                vsg::ref_ptr<vsg::VertexIndexDraw> vid;
+                vsg::ref_ptr<vsg::vec3Array> positions;
+            };
+
+            bool optimizeGeometry = false;
+            GeometryOptimizer geometryOptimizer;
+            std::vector<OptimizableTriangles> optimizableTriangles;
+            std::map<const vsg::Data*, uint32_t> vertexArrayUsage;
+
+            // indexed triangle lists collected by createMesh(..) to be split into clusters
+            struct ClusterableTriangles
+            {
+                vsg::ref_ptr<vsg::StateGroup> stateGroup;
+                vsg::ref_ptr<vsg::VertexIndexDraw> vid;
+                vsg::ref_ptr<vsg::vec3Array> positions;
+                bool backFaceCulling = true;
+            };
+
+            // primitives without indices collected by createMesh(..) to have their vertices welded
+            struct WeldableDraw
+            {
+                vsg::ref_ptr<vsg::VertexIndexDraw> vid;
+                vsg::DataList arrays;
+                uint32_t numVertices = 0;
+            };
+
+            bool generateIndices = false;
+            VertexWelder vertexWelder;
+            std::vector<WeldableDraw> weldableDraws;
+
+            // the vertex arrays of a primitive that the shaderSet has attributes for, in the order they are assigned to a GraphicsPipelineConfigurator
+            struct VertexBinding
+            {
+                std::string name;
+                VkVertexInputRate vertexInputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+                vsg::ref_ptr<vsg::Data> data;
+            };
+
+            // the state created by createMesh(..) for each combination of material, vertex bindings, topology and interleaving, keyed by
+            // the bytes of the combination, so primitives that repeat a combination skip configuring and initializing a GraphicsPipelineConfigurator
+            std::unordered_map<std::string, vsg::ref_ptr<vsg::StateGroup>> pipelineStates;
+
+            // primitives collected by createMesh(..) to have their per vertex arrays packed into a single interleaved array
+            struct InterleavableDraw
+            {
+                vsg::ref_ptr<vsg::Command> draw;
+                std::vector<uint32_t> offsets;
+                uint32_t stride = 0;
+            };
+
+            bool interleaveVertices = false;
+            std::vector<InterleavableDraw> interleavableDraws;
+
+            bool buildClusters = false;
+            ClusterBuilder clusterBuilder;
+            std::vector<ClusterableTriangles> clusterableTriangles;
+
+            // opaque point, line and triangle lists collected by createMesh(..) that may have transforms baked into them or be merged once the scenes are built
+            bool flattenStaticTransforms = false;
+            bool batchStaticGeometry = false;
+            GeometryBatcher geometryBatcher;
+            std::map<const vsg::Command*, GeometryBatcher::Primitive> staticPrimitives;
+
+            ImagePreparer imagePreparer;
+            BlockCompressor blockCompressor;
+
             std::vector<vsg::ref_ptr<vsg::Data>> vsg_buffers;
             std::vector<vsg::ref_ptr<vsg::Data>> vsg_bufferViews;
             std::vector<vsg::ref_ptr<vsg::Data>> vsg_accessors;
@@ -531,7 +1292,9 @@ namespace vsgXchange
 
             vsg::ref_ptr<vsg::Data> createBuffer(vsg::ref_ptr<gltf::Buffer> gltf_buffer);
             vsg::ref_ptr<vsg::Data> createBufferView(vsg::ref_ptr<gltf::BufferView> gltf_bufferView);
+            vsg::ref_ptr<vsg::Data> createBufferView(glTFid buffer, uint32_t byteOffset, uint32_t byteLength, uint32_t byteStride);
             vsg::ref_ptr<vsg::Data> createAccessor(vsg::ref_ptr<gltf::Accessor> gltf_accessor);
+            vsg::ref_ptr<vsg::Data> createAccessor(glTFid bufferView, uint32_t byteOffset, uint32_t componentType, const std::string_view& type, uint32_t count);
             vsg::ref_ptr<vsg::Camera> createCamera(vsg::ref_ptr<gltf::Camera> gltf_camera);
             vsg::ref_ptr<vsg::Sampler> createSampler(vsg::ref_ptr<gltf::Sampler> gltf_sampler);
             vsg::ref_ptr<vsg::Data> createImage(vsg::ref_ptr<gltf::Image> gltf_image);
@@ -539,17 +1302,195 @@ namespace vsgXchange
             vsg::ref_ptr<vsg::DescriptorConfigurator> createMaterial(vsg::ref_ptr<gltf::Material> gltf_material);
             vsg::ref_ptr<vsg::Node> createMesh(vsg::ref_ptr<gltf::Mesh> gltf_mesh);
             vsg::ref_ptr<vsg::Node> createNode(vsg::ref_ptr<gltf::Node> gltf_node);
+            vsg::ref_ptr<vsg::Node> createNode(glTFid camera, glTFid skin, glTFid mesh, size_t numChildren, const vsg::dmat4* matrix);
             vsg::ref_ptr<vsg::Node> createScene(vsg::ref_ptr<gltf::Scene> gltf_scene);
 
             vsg::ref_ptr<vsg::Object> createSceneGraph(vsg::ref_ptr<gltf::glTF> root, vsg::ref_ptr<const vsg::Options> options);
+
+            // compact document support, creating the accessors, bufferViews and nodes directly from the CompactDocument tables
+            void createAccessors(const CompactDocument& compact);
+            void createBufferViews(const CompactDocument& compact);
+            void createNodes(const CompactDocument& compact);
+
+            /// downscale the vsg_images larger than maxTextureSize, then those with the most pixels for the size of the meshes using them until the
+            /// images fit in textureBudget bytes, distributing the images across the operationThreads.
+            void downscaleImages(const gltf::glTF& root, uint32_t maxTextureSize, size_t textureBudget, bool mipmaps, vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report);
+
+            /// convert the vsg_images to RGBA with mipmaps, distributing the images across the operationThreads.
+            void prepareImages(vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report);
+
+            /// block compress the vsg_images, distributing the images across the operationThreads, with the images only used as normal maps encoded as NORMAL_MAP.
+            void compressImages(const gltf::glTF& root, vsg::ref_ptr<const vsg::Options> options, bool report);
+
+            /// weld the collected weldableDraws, assigning the generated indices and compacted arrays to their VertexIndexDraw.
+            void weldVertices(vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report);
+
+            /// optimize the collected optimizableTriangles, distributing the work across the operationThreads. Vertices are only reordered
+            /// when none of a primitive's vertex arrays are used by other primitives.
+            GeometryOptimizer::Statistics optimizeTriangles(vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report);
+
+            /// pack the per vertex arrays of the collected interleavableDraws into one array matching the layout assigned to their pipeline,
+            /// using a view of the source data when it's still interleaved in that layout.
+            void interleaveVertexArrays(vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report);
+
+            /// replace the VertexIndexDraw of the collected clusterableTriangles with clusters, distributing the work across the operationThreads.
+            void createClusters(vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report);
+
+            /// bake the matrix transforms above the staticPrimitives that aren't instanced into their positions and normals, replacing the transforms
+            /// by groups. Transforms of nodes that are animated, skin joints or hold cameras or skins, and anything instanced, are kept with the
+            /// transforms above them collapsed into one.
+            void flattenTransforms(const gltf::glTF& root, vsg::ref_ptr<vsg::OperationThreads> operationThreads, bool report);
+
+            /// merge the staticPrimitives only groups, matrix transforms and cull nodes in the vsg_scenes into a StateGroup per batch
+            /// added to each scene, removing them from their parents.
+            void batchGeometry(bool report);
+
+            /// remove empty groups, collapse groups with a single child and move the children of plain groups into their parents, merging sibling
+            /// StateGroups with the same stateCommands. Nodes with more than one parent or with a name or extras are kept.
+            void simplifySceneGraph(bool report);
+
+            /// order sibling StateGroups by their stateCommands, slot by slot, then by the vertex arrays of their draw so the record traversal binds
+            /// each pipeline and descriptor set fewer times, and move the stateCommands shared by all the StateGroup children of a group up into it.
+            void sortState(bool report);
+
+            /// copy the arrays in the scene graph that are views into the glTF buffers into right-sized arrays and drop the builder's and root's references
+            /// to the buffers, bufferViews and accessors so they can be released. Returns the number of bytes reclaimed, the size of the buffers
+            /// actually freed less the size of the compacted copies, so buffers still referenced elsewhere count for nothing.
+            size_t releaseBuffers(gltf::glTF& root, vsg::Object& scene, bool report);
         };
 
         /// function for extracting components of a uri
         static bool dataURI(const std::string_view& uri, std::string_view& mimeType, std::string_view& encoding, std::string_view& value);
 
+        /// positions of the structural characters of a JSON buffer, the {}[]:, outside of strings and the opening quote of each string,
+        /// found 64 bytes at a time using SSE2 (with a scalar fallback) in the style of simdjson's stage 1, along with the pairing of brackets.
+        /// Used to validate the document up front and to skip over or split JSON values without scanning them a character at a time. The properties
+        /// themselves are still read by vsg::JSONParser's own character scanning, which the index can't drive.
+        struct StructuralIndex : public vsg::Inherit<vsg::Object, StructuralIndex>
+        {
+            static constexpr uint32_t invalid_index = std::numeric_limits<uint32_t>::max();
+
+            /// key used to assign the StructuralIndex to the JSONParser
+            static const std::string key;
+
+            std::vector<uint32_t> positions;
+            std::vector<uint32_t> matching; // for each opening bracket, the index in positions of its closing bracket
+
+            /// build the index, returning false if the buffer has unterminated strings or unbalanced brackets, or is larger than 4GB.
+            bool build(const std::string& buffer);
+
+            /// index in positions of the structural character at pos, or invalid_index if pos isn't a structural character.
+            uint32_t index(size_t pos) const;
+
+            /// position of the bracket matching the opening bracket at pos, or std::string::npos if not known.
+            size_t closing(size_t pos) const;
+
+            /// return true if build() uses SSE2
+            static bool simd();
+        };
+
+        /// images and buffers registered by loads sharing a vsg::SharedObjects, found by an XXH64 hash of their properties, dimensions and
+        /// contents so identical data read from different files is shared. Only observed, so the registry doesn't keep data alive.
+        /// Obtained by sharedObjects->shared_default<gltf::ContentRegistry>().
+        class ContentRegistry : public vsg::Inherit<vsg::Object, ContentRegistry>
+        {
+        public:
+            /// return the registered data with the same type, properties, dimensions and contents as data, otherwise register data and return it.
+            vsg::ref_ptr<vsg::Data> share(vsg::ref_ptr<vsg::Data> data);
+
+            /// XXH64 hash of size bytes at ptr.
+            static uint64_t hash(const void* ptr, size_t size, uint64_t seed = 0);
+
+            /// remove the registrations of data no longer referenced, erasing the hashes left without any. Called by share(..) each time
+            /// the number of hashes doubles so the registry doesn't grow with every load made through the SharedObjects.
+            void prune();
+
+            /// number of data shared in place of duplicates, and the bytes of the duplicates, over all loads.
+            std::atomic<uint64_t> numShared{0};
+            std::atomic<uint64_t> bytesSaved{0};
+
+        protected:
+            void _prune();
+
+            std::mutex _mutex;
+            std::unordered_map<uint64_t, std::vector<vsg::observer_ptr<vsg::Data>>> _registered;
+            size_t _pruneSize = 1024; // number of hashes at which share(..) next prunes
+        };
+
+        /// cache of the external images and buffers read by loads, keyed by resolved filename and modification time, holding up to maxMemory
+        /// bytes of data with the least recently used evicted first. Concurrent reads of a file wait for the first read rather than reading it
+        /// again. Cached data stays resident until evicted, even when the loads that read it have released it. Failed reads aren't cached.
+        /// Shared between loads by assigning it to their vsg::Options with options->setObject(gltf::ResourceCache::key, resourceCache).
+        /// The same Data is returned to every load of a file, so callers must treat it as read only and copy it before modifying it.
+        class ResourceCache : public vsg::Inherit<vsg::Object, ResourceCache>
+        {
+        public:
+            explicit ResourceCache(size_t in_maxMemory = size_t(1) << 30);
+
+            /// key used to assign the ResourceCache to vsg::Options
+            static const std::string key;
+
+            size_t maxMemory;
+
+            /// return the data read from filename, reading it if it's not cached or its modification time has changed.
+            /// The returned data is shared with other reads of the file so must not be modified.
+            vsg::ref_ptr<vsg::Data> read(const vsg::Path& filename, vsg::ref_ptr<const vsg::Options> options) const;
+
+            struct Stats
+            {
+                size_t hits = 0;
+                size_t misses = 0;
+                size_t coalesced = 0; // reads that waited on a read of the same file already in flight
+                size_t evictions = 0;
+                size_t memory = 0;
+            };
+
+            Stats stats() const;
+
+        protected:
+            struct Entry
+            {
+                vsg::ref_ptr<vsg::Data> data;
+                size_t size = 0;
+                bool ready = false;
+                std::list<std::string>::iterator lru;
+            };
+
+            // the cache is updated by reads through the const vsg::Options it's assigned to
+            mutable std::mutex _mutex;
+            mutable std::condition_variable _ready;
+            mutable std::unordered_map<std::string, Entry> _entries;
+            mutable std::list<std::string> _lru; // keys of the ready entries, most recently used first
+            mutable Stats _stats;
+        };
+
+        /// create an array of the same type and format as data with numElements elements, or null if the type isn't one used for glTF accessors.
+        static vsg::ref_ptr<vsg::Data> createCompatibleArray(vsg::Data& data, uint32_t numElements);
+
+        /// create a view of the same type and format as data onto storage, starting offset bytes in and stepping stride bytes between elements,
+        /// or null if the type isn't one used for glTF accessors.
+        static vsg::ref_ptr<vsg::Data> createArrayView(vsg::Data& data, vsg::ref_ptr<vsg::Data> storage, uint32_t offset, uint32_t stride, uint32_t numElements);
+
+        /// copy count values from src to dest, which must have the same value size, a value at a time so either may be a strided view.
+        static void copyValues(const vsg::Data& src, size_t srcIndex, vsg::Data& dest, size_t destIndex, size_t count);
+
+        /// call func(i) for i in [0, count), distributing the calls across the operationThreads with the calling thread also taking part,
+        /// returning once all calls have completed. When operationThreads is null the calls are made serially on the calling thread.
+        static void parallel_for(vsg::ref_ptr<vsg::OperationThreads> operationThreads, size_t count, const std::function<void(size_t)>& func);
+
+        /// compute a node's local transform from either its matrix or its translation, rotation and scale values.
+        static vsg::dmat4 nodeMatrix(const double* m, size_t m_size, const double* t, size_t t_size, const double* r, size_t r_size, const double* s, size_t s_size);
+
         /// function for mapping a mimeType to .extension that can be used with vsgXchange's plugins.
         static vsg::Path mimeTypeToExtension(const std::string_view& mimeType);
 
+        /// read the raw JSON text of the object or array at parser.pos, advancing parser.pos past its closing bracket.
+        static bool read_json(vsg::JSONParser& parser, std::string_view& json);
+
+        /// read the JSON text from the stream in chunks into buffer, decoding base64 data URIs as they are read into streamedData
+        /// and replacing them in the buffer with "data:<mimeType>;streamed,<index>" so the encoded text is never held in memory.
+        static bool read_streamed(std::istream& fin, std::string& buffer, std::vector<vsg::ref_ptr<vsg::Data>>& streamedData, size_t chunkSize = 1 << 20);
+
     };
 
     /// output stream support for glTFid
@@ -563,11 +1504,14 @@ namespace vsgXchange
     /// input stream support for glTFid
     inline std::istream& operator>>(std::istream& input, gltf::glTFid& id)
     {
-        input >> id.value;
+        gltf::parse_value(input, id.value);
         return input;
     }
 
 }
 
 EVSG_type_name(vsgXchange::gltf)
+EVSG_type_name(vsgXchange::gltf::Summary)
+EVSG_type_name(vsgXchange::gltf::LazyExtras)
+EVSG_type_name(vsgXchange::gltf::ClusterCullNode)
 
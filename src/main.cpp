@@ -6,10 +6,199 @@
 #endif
 
 #include <iostream>
+#include <thread>
 
 #include "gltf.h"
 #include "bin.h"
 
+// read a single file, recording how long the read took so per file timings can be reported.
+struct ReadFileOperation : public vsg::Inherit<vsg::Operation, ReadFileOperation>
+{
+    vsg::Path filename;
+    vsg::ref_ptr<const vsg::Options> options;
+    vsg::ref_ptr<vsg::Latch> latch;
+
+    // results
+    vsg::ref_ptr<vsg::Object> object;
+    double duration = 0.0;
+
+    ReadFileOperation(const vsg::Path& f, vsg::ref_ptr<const vsg::Options> o) :
+        filename(f),
+        options(o) {}
+
+    void run() override
+    {
+        auto before_read = vsg::clock::now();
+        object = vsg::read(filename, options);
+        duration = std::chrono::duration<double, std::chrono::seconds::period>(vsg::clock::now() - before_read).count();
+
+        if (latch) latch->count_down();
+    }
+};
+
+// CPU benchmark of the culling of gltf::ClusterCullNode, counting the triangles rejected by the view frustum and by the normal cones for a single view.
+struct ClusterCullStats : public vsg::Inherit<vsg::ConstVisitor, ClusterCullStats>
+{
+    std::vector<vsg::dmat4> modelviewStack;
+    std::vector<vsg::dvec4> planes;
+
+    size_t numClusters = 0;
+    size_t numTriangles = 0;
+    size_t frustumCulled = 0;
+    size_t backFaceCulled = 0;
+
+    ClusterCullStats(const vsg::dmat4& projection, const vsg::dmat4& view) :
+        modelviewStack{view}
+    {
+        // left, right, bottom and top planes of the frustum in eye coordinates
+        auto row = [&](int r) { return vsg::dvec4(projection[0][r], projection[1][r], projection[2][r], projection[3][r]); };
+        for(auto plane : {row(3) + row(0), row(3) - row(0), row(3) + row(1), row(3) - row(1)})
+        {
+            planes.push_back(plane / vsg::length(vsg::dvec3(plane.x, plane.y, plane.z)));
+        }
+    }
+
+    void apply(const vsg::Node& node) override
+    {
+        if (auto cullNode = dynamic_cast<const vsgXchange::gltf::ClusterCullNode*>(&node)) cull(*cullNode);
+        else node.traverse(*this);
+    }
+
+    void apply(const vsg::Transform& transform) override
+    {
+        modelviewStack.push_back(transform.transform(modelviewStack.back()));
+        transform.traverse(*this);
+        modelviewStack.pop_back();
+    }
+
+    void cull(const vsgXchange::gltf::ClusterCullNode& cullNode)
+    {
+        ++numClusters;
+        numTriangles += cullNode.numTriangles;
+
+        auto& modelview = modelviewStack.back();
+        vsg::dvec3 center = modelview * cullNode.bound.center;
+        double radius = cullNode.bound.radius * vsg::length(vsg::dvec3(modelview[0][0], modelview[0][1], modelview[0][2]));
+        for(auto& plane : planes)
+        {
+            if (plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w < -radius)
+            {
+                frustumCulled += cullNode.numTriangles;
+                return;
+            }
+        }
+
+        if (cullNode.backFacing(modelview)) backFaceCulled += cullNode.numTriangles;
+    }
+};
+
+// headless count of the binds made by the record traversal, with a StateGroup's state commands only recorded before a draw when they differ from
+// the command last recorded in their slot.
+struct StateChangeStats : public vsg::Inherit<vsg::ConstVisitor, StateChangeStats>
+{
+    std::vector<std::vector<const vsg::StateCommand*>> stateStacks;
+    std::vector<const vsg::StateCommand*> recorded;
+    const vsg::Data* vertexArray = nullptr;
+
+    size_t numDraws = 0;
+    size_t pipelineBinds = 0;
+    size_t descriptorBinds = 0;
+    size_t vertexArrayChanges = 0;
+
+    void apply(const vsg::Node& node) override { node.traverse(*this); }
+
+    void apply(const vsg::StateGroup& stateGroup) override
+    {
+        for(auto& stateCommand : stateGroup.stateCommands)
+        {
+            if (stateCommand->slot >= stateStacks.size())
+            {
+                stateStacks.resize(stateCommand->slot + 1);
+                recorded.resize(stateCommand->slot + 1, nullptr);
+            }
+            stateStacks[stateCommand->slot].push_back(stateCommand.get());
+        }
+
+        stateGroup.traverse(*this);
+
+        for(auto& stateCommand : stateGroup.stateCommands) stateStacks[stateCommand->slot].pop_back();
+    }
+
+    void apply(const vsg::VertexIndexDraw& vid) override
+    {
+        bindVertexArrays(vid.arrays);
+        draw();
+    }
+
+    void apply(const vsg::VertexDraw& vd) override
+    {
+        bindVertexArrays(vd.arrays);
+        draw();
+    }
+
+    void apply(const vsg::BindVertexBuffers& bvb) override { bindVertexArrays(bvb.arrays); }
+    void apply(const vsg::DrawIndexed&) override { draw(); }
+    void apply(const vsg::Draw&) override { draw(); }
+
+    void bindVertexArrays(const vsg::BufferInfoList& arrays)
+    {
+        if (!arrays.empty() && arrays.front() && arrays.front()->data.get() != vertexArray)
+        {
+            vertexArray = arrays.front()->data.get();
+            ++vertexArrayChanges;
+        }
+    }
+
+    void draw()
+    {
+        ++numDraws;
+
+        for(size_t slot = 0; slot < stateStacks.size(); ++slot)
+        {
+            if (stateStacks[slot].empty() || stateStacks[slot].back() == recorded[slot]) continue;
+
+            recorded[slot] = stateStacks[slot].back();
+            if (dynamic_cast<const vsg::BindGraphicsPipeline*>(recorded[slot])) ++pipelineBinds;
+            else ++descriptorBinds;
+        }
+    }
+};
+
+// report the triangles of the clusters rejected for a series of views orbiting the scene, alternating between views of the whole scene and close ups.
+void reportClusterCulling(vsg::ref_ptr<vsg::Node> scene, uint32_t numViews)
+{
+    auto bounds = vsg::visit<vsg::ComputeBounds>(scene).bounds;
+    vsg::dvec3 centre = (bounds.min + bounds.max) * 0.5;
+    double radius = vsg::length(bounds.max - bounds.min) * 0.6;
+
+    auto projection = vsg::Perspective::create(30.0, 1.0, 0.0001 * radius, radius * 4.5)->transform();
+
+    size_t totalTriangles = 0;
+    size_t totalRejected = 0;
+    for(uint32_t v = 0; v < numViews; ++v)
+    {
+        double angle = 2.0 * vsg::PI * static_cast<double>(v) / static_cast<double>(numViews);
+        double distance = (v % 2 == 0) ? radius * 3.5 : radius * 1.5;
+        vsg::dvec3 eye = centre + vsg::dvec3(std::sin(angle) * distance, -std::cos(angle) * distance, distance * 0.25);
+        auto view = vsg::LookAt::create(eye, centre, vsg::dvec3(0.0, 0.0, 1.0))->transform();
+
+        auto before_cull = vsg::clock::now();
+        auto stats = ClusterCullStats::create(projection, view);
+        scene->accept(*stats);
+        double duration = std::chrono::duration<double, std::chrono::milliseconds::period>(vsg::clock::now() - before_cull).count();
+
+        size_t rejected = stats->frustumCulled + stats->backFaceCulled;
+        double percentage = stats->numTriangles > 0 ? 100.0 * static_cast<double>(rejected) / static_cast<double>(stats->numTriangles) : 0.0;
+        std::cout<<"view "<<v<<" : clusters = "<<stats->numClusters<<", triangles = "<<stats->numTriangles<<", frustum culled = "<<stats->frustumCulled
+                 <<", back face culled = "<<stats->backFaceCulled<<", rejected = "<<percentage<<"%, time = "<<duration<<"ms"<<std::endl;
+
+        totalTriangles += stats->numTriangles;
+        totalRejected += rejected;
+    }
+
+    if (totalTriangles > 0) std::cout<<"average triangles rejected per view = "<<(100.0 * static_cast<double>(totalRejected) / static_cast<double>(totalTriangles))<<"%"<<std::endl;
+}
+
 int main(int argc, char** argv)
 {
     auto options = vsg::Options::create();
@@ -35,6 +224,25 @@ int main(int argc, char** argv)
     uint32_t numOperationThreads = 0;
     if (arguments.read("--ot", numOperationThreads)) options->operationThreads = vsg::OperationThreads::create(numOperationThreads);
 
+    // number of threads to use when reading multiple files, the main thread also reads so 0 reads all files serially.
+    uint32_t numReadThreads = std::max(1u, std::thread::hardware_concurrency()) - 1;
+    arguments.read("--rt", numReadThreads);
+
+    // number of views for a CPU benchmark of the cluster culling enabled by the gltf::meshlets option
+    uint32_t numCullViews = 0;
+    arguments.read("--cull-stats", numCullViews);
+
+    // report the binds made recording the scene, to compare the effect of the gltf::sort_state option
+    bool stateStats = arguments.read("--state-stats");
+
+    // share the external images and buffers read by the loads through a cache with a budget in MB
+    vsg::ref_ptr<vsgXchange::gltf::ResourceCache> resourceCache;
+    if (size_t resourceCacheMB = 0; arguments.read("--resource-cache", resourceCacheMB))
+    {
+        resourceCache = vsgXchange::gltf::ResourceCache::create(resourceCacheMB * 1024 * 1024);
+        options->setObject(vsgXchange::gltf::ResourceCache::key, resourceCache);
+    }
+
     auto gltf = vsgXchange::gltf::create();
     if (int log_level = 0; arguments.read("--log-level", log_level)) gltf->level = vsg::Logger::Level(log_level);
 
@@ -57,18 +265,52 @@ int main(int argc, char** argv)
 
     auto before_read = vsg::clock::now();
 
-    // read any vsg files from command line arguments
+    // read any vsg files from command line arguments, with all the reads sharing the same options->sharedObjects
+    std::vector<vsg::ref_ptr<ReadFileOperation>> operations;
     for (int i=1; i<argc; ++i)
     {
-        vsg::Path filename = arguments[i];
-        if (auto object = vsg::read(filename, options))
+        operations.push_back(ReadFileOperation::create(arguments[i], options));
+    }
+
+    if (operations.size() > 1 && numReadThreads > 0)
+    {
+        auto readThreads = vsg::OperationThreads::create(std::min(numReadThreads, static_cast<uint32_t>(operations.size()) - 1));
+        auto latch = vsg::Latch::create(static_cast<int>(operations.size()));
+        for(auto& operation : operations)
         {
-            group->addChild(object);
-            arguments.remove(i, 1);
-            --i;
+            operation->latch = latch;
+            readThreads->add(operation);
+        }
+
+        // use this thread to read the files as well
+        readThreads->run();
+
+        // wait till all the read operations have completed
+        latch->wait();
+    }
+    else
+    {
+        for(auto& operation : operations)
+        {
+            operation->run();
         }
     }
 
+    // add the loaded objects in command line order so the result is independent of which thread finished first
+    for(auto& operation : operations)
+    {
+        if (operation->object)
+        {
+            group->addChild(operation->object);
+            std::cout<<"time to read "<<operation->filename<<" "<<operation->duration<<std::endl;
+        }
+    }
+
+    // remove the arguments that were successfully read, in reverse order so the remaining indices stay valid
+    for (int i=static_cast<int>(operations.size()); i>=1; --i)
+    {
+        if (operations[i-1]->object) arguments.remove(i, 1);
+    }
 
     if (group->children.empty())
     {
@@ -78,6 +320,13 @@ int main(int argc, char** argv)
     auto after_read = vsg::clock::now();
     std::cout<<"time to read data "<<std::chrono::duration<double, std::chrono::seconds::period>(after_read - before_read).count()<<std::endl;
 
+    if (resourceCache)
+    {
+        auto stats = resourceCache->stats();
+        std::cout<<"resource cache hits = "<<stats.hits<<", misses = "<<stats.misses<<", coalesced = "<<stats.coalesced
+                 <<", evictions = "<<stats.evictions<<", memory = "<<stats.memory<<std::endl;
+    }
+
 
     if (outputFilename)
     {
@@ -102,6 +351,7 @@ int main(int argc, char** argv)
                 node_group->addChild(node);
             }
         }
+        scene = node_group;
     }
 
     if (!scene)
@@ -110,6 +360,16 @@ int main(int argc, char** argv)
         return 0;
     }
 
+    if (numCullViews > 0) reportClusterCulling(scene, numCullViews);
+
+    if (stateStats)
+    {
+        auto stats = StateChangeStats::create();
+        scene->accept(*stats);
+        std::cout<<"draws = "<<stats->numDraws<<", pipeline binds = "<<stats->pipelineBinds<<", descriptor binds = "<<stats->descriptorBinds
+                 <<", vertex array changes = "<<stats->vertexArrayChanges<<std::endl;
+    }
+
     auto numFrames = arguments.value<uint32_t>(-1, "--nf");
     if (numFrames == 0) return 0;
 